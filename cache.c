@@ -0,0 +1,346 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "xmalloc.h"
+#include "hash.h"
+#include "sink.h"
+#include "cache.h"
+
+/*
+ * The implementation of the cache of conversion results.
+ *
+ * Each cache entry is a file in the cache directory, named by
+ * the hex digest of the program version, the options, the input
+ * file name, and the input file contents.  It starts with header
+ * lines listing the exit status, the output file name, and the
+ * digests of all the files read while parsing, followed by an
+ * empty line, the formatted output, and the messages.
+ * An entry is only used if all files read still have the same
+ * digests and all files that were missing are still missing.
+ * It is only stored if none of the files read changed between
+ * being opened by the parser and being hashed afterwards.
+ */
+
+#ifndef VERSION
+#define	VERSION		"unknown"
+#endif
+
+#define	CACHE_MAGIC	"docbook2mdoc cache 2"
+
+
+void
+centry_init(struct centry *ce)
+{
+	memset(ce, 0, sizeof(*ce));
+	sink_init_buf(&ce->out);
+	sink_init_buf(&ce->msgs);
+}
+
+/*
+ * Record a file read while parsing, unless already recorded.
+ * If st is not NULL, it describes the file as it was opened.
+ */
+void
+centry_adddep(struct centry *ce, const char *path, int found,
+    const struct stat *st)
+{
+	struct cdep	*dep;
+	size_t		 i;
+
+	for (i = 0; i < ce->depsz; i++)
+		if (strcmp(ce->deps[i].path, path) == 0)
+			return;
+	if (ce->depsz == ce->depmax) {
+		ce->depmax = ce->depmax == 0 ? 16 : ce->depmax * 2;
+		ce->deps = xreallocarray(ce->deps,
+		    ce->depmax, sizeof(*ce->deps));
+	}
+	dep = ce->deps + ce->depsz++;
+	memset(dep, 0, sizeof(*dep));
+	dep->path = xstrdup(path);
+	dep->found = found;
+	if (st != NULL) {
+		dep->dev = st->st_dev;
+		dep->ino = st->st_ino;
+		dep->size = st->st_size;
+		dep->mtime = st->st_mtim;
+		dep->known = 1;
+	}
+}
+
+/*
+ * Check whether the file st is still the one recorded in dep.
+ */
+static int
+cdep_same(const struct cdep *dep, const struct stat *st)
+{
+	return dep->known && dep->dev == st->st_dev &&
+	    dep->ino == st->st_ino && dep->size == st->st_size &&
+	    dep->mtime.tv_sec == st->st_mtim.tv_sec &&
+	    dep->mtime.tv_nsec == st->st_mtim.tv_nsec;
+}
+
+/*
+ * Compute the hex digest of the file read as dep.
+ * Return 0 on success, or -1 if the file cannot be read or
+ * if it changed since it was opened by the parser, such that
+ * the digest might not match the contents actually parsed.
+ */
+static int
+cdep_hash(const struct cdep *dep, char *hex)
+{
+	struct stat	 st;
+	int		 fd, rc;
+
+	if (dep->known == 0 || (fd = open(dep->path, O_RDONLY, 0)) == -1)
+		return -1;
+	rc = fstat(fd, &st) == 0 && cdep_same(dep, &st) &&
+	    hash_fd(fd, hex) == 0 && fstat(fd, &st) == 0 &&
+	    cdep_same(dep, &st) ? 0 : -1;
+	close(fd);
+	return rc;
+}
+
+void
+centry_free(struct centry *ce)
+{
+	size_t		 i;
+
+	for (i = 0; i < ce->depsz; i++)
+		free(ce->deps[i].path);
+	free(ce->deps);
+	free(ce->oname);
+	sink_free(&ce->out);
+	sink_free(&ce->msgs);
+}
+
+/*
+ * Read a complete file into a NUL-terminated buffer
+ * and store its length in *sz and its status in *st.
+ * Return NULL with errno set if the file cannot be read.
+ */
+char *
+cache_readfile(const char *fname, size_t *sz, struct stat *st)
+{
+	char		*b;
+	size_t		 bsz;
+	ssize_t		 rsz;
+	int		 fd, save_errno;
+
+	if ((fd = open(fname, O_RDONLY, 0)) == -1)
+		return NULL;
+	if (fstat(fd, st) == -1) {
+		save_errno = errno;
+		close(fd);
+		errno = save_errno;
+		return NULL;
+	}
+	bsz = S_ISREG(st->st_mode) && st->st_size > 0 ?
+	    (size_t)st->st_size + 1 : 8192;
+	b = xcalloc(1, bsz);
+	*sz = 0;
+	for (;;) {
+		if (*sz + 1 == bsz) {
+			bsz *= 2;
+			b = xrealloc(b, bsz);
+		}
+		if ((rsz = read(fd, b + *sz, bsz - *sz - 1)) == -1) {
+			if (errno == EINTR)
+				continue;
+			save_errno = errno;
+			close(fd);
+			free(b);
+			errno = save_errno;
+			return NULL;
+		}
+		if (rsz == 0)
+			break;
+		*sz += rsz;
+	}
+	close(fd);
+	b[*sz] = '\0';
+	return b;
+}
+
+/*
+ * Compute the key of the cache entry for the input file fname
+ * with the contents buf of size sz, converted with the options
+ * opts, and store it in key[HASH_HEXSZ].
+ */
+void
+cache_key(char *key, const char *opts, const char *fname,
+    const char *buf, size_t sz)
+{
+	struct hash	 h;
+
+	hash_init(&h);
+	hash_update(&h, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	hash_update(&h, VERSION, sizeof(VERSION));
+	hash_update(&h, opts, strlen(opts) + 1);
+	hash_update(&h, fname, strlen(fname) + 1);
+	hash_update(&h, buf, sz);
+	hash_final(&h, key);
+}
+
+/*
+ * Look up the cache entry key in the cache directory dir
+ * and fill in ce from it, which must be freshly initialized.
+ * Return 0 on success, or -1 if there is no valid entry,
+ * in which case ce is left unchanged.
+ */
+int
+cache_get(const char *dir, const char *key, struct centry *ce)
+{
+	struct centry	 new;
+	struct stat	 st;
+	const char	*errstr;
+	char		*b, *cp, *ep, *eol, *line, *val, *path;
+	char		 hex[HASH_HEXSZ];
+	size_t		 sz, outsz, msgsz;
+	int		 found;
+
+	xasprintf(&path, "%s/%s", dir, key);
+	b = cache_readfile(path, &sz, &st);
+	free(path);
+	if (b == NULL)
+		return -1;
+
+	centry_init(&new);
+	outsz = msgsz = SIZE_MAX;
+	ep = b + sz;
+	if (sz < sizeof(CACHE_MAGIC) ||
+	    memcmp(b, CACHE_MAGIC "\n", sizeof(CACHE_MAGIC)) != 0)
+		goto fail;
+	cp = b + sizeof(CACHE_MAGIC);
+	for (;;) {
+		if ((eol = memchr(cp, '\n', ep - cp)) == NULL)
+			goto fail;
+		*eol = '\0';
+		line = cp;
+		cp = eol + 1;
+		if (*line == '\0')
+			break;
+		if ((val = strchr(line, ' ')) == NULL)
+			goto fail;
+		*val++ = '\0';
+		errstr = NULL;
+		if (strcmp(line, "rc") == 0)
+			new.rc = strtonum(val, 0, 3, &errstr);
+		else if (strcmp(line, "oname") == 0) {
+			free(new.oname);
+			new.oname = xstrdup(val);
+		} else if (strcmp(line, "output") == 0)
+			outsz = strtonum(val, 0, INT32_MAX, &errstr);
+		else if (strcmp(line, "messages") == 0)
+			msgsz = strtonum(val, 0, INT32_MAX, &errstr);
+		else if (strcmp(line, "dep") == 0) {
+
+			/* Check that the file did not change. */
+
+			if ((path = strchr(val, ' ')) == NULL)
+				goto fail;
+			*path++ = '\0';
+			found = strcmp(val, "-") != 0;
+			if (hash_file(path, hex) == 0 ?
+			    found == 0 || strcmp(val, hex) != 0 : found)
+				goto fail;
+			centry_adddep(&new, path, found, NULL);
+		} else
+			goto fail;
+		if (errstr != NULL)
+			goto fail;
+	}
+	if (outsz == SIZE_MAX || msgsz == SIZE_MAX ||
+	    (size_t)(ep - cp) != outsz + msgsz)
+		goto fail;
+	sink_write(&new.out, cp, outsz);
+	sink_write(&new.msgs, cp + outsz, msgsz);
+	free(b);
+	centry_free(ce);
+	*ce = new;
+	return 0;
+
+fail:
+	free(b);
+	centry_free(&new);
+	return -1;
+}
+
+/*
+ * Store ce as the cache entry key in the cache directory dir.
+ * Write a temporary file first and rename it, such that concurrent
+ * readers never see incomplete entries.  This is done on a
+ * best-effort basis; failure merely prevents later cache hits.
+ */
+void
+cache_put(const char *dir, const char *key, const struct centry *ce)
+{
+	struct sink	 s;
+	const struct cdep *dep;
+	char		*tmp, *path;
+	char		 hex[HASH_HEXSZ];
+	size_t		 i;
+	int		 fd, rc;
+
+	xasprintf(&tmp, "%s/tmp.XXXXXXXXXX", dir);
+	if ((fd = mkstemp(tmp)) == -1) {
+		free(tmp);
+		return;
+	}
+	sink_init_fd(&s, fd);
+	sink_printf(&s, "%s\nrc %d\n", CACHE_MAGIC, ce->rc);
+	if (ce->oname != NULL)
+		sink_printf(&s, "oname %s\n", ce->oname);
+	rc = 0;
+	for (i = 0; i < ce->depsz && rc == 0; i++) {
+		dep = ce->deps + i;
+		if (strchr(dep->path, '\n') != NULL)
+			rc = -1;
+		else if (dep->found == 0)
+			sink_printf(&s, "dep - %s\n", dep->path);
+		else if ((rc = cdep_hash(dep, hex)) == 0)
+			sink_printf(&s, "dep %s %s\n", hex, dep->path);
+	}
+	sink_printf(&s, "output %zu\nmessages %zu\n\n",
+	    ce->out.len, ce->msgs.len);
+	sink_write(&s, ce->out.b, ce->out.len);
+	sink_write(&s, ce->msgs.b, ce->msgs.len);
+	if (sink_flush(&s) == -1)
+		rc = -1;
+	sink_free(&s);
+	if (close(fd) == -1)
+		rc = -1;
+	if (rc == 0) {
+		xasprintf(&path, "%s/%s", dir, key);
+		if (rename(tmp, path) == -1)
+			rc = -1;
+		free(path);
+	}
+	if (rc == -1)
+		unlink(tmp);
+	free(tmp);
+}
@@ -0,0 +1,60 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * The interface of the cache of conversion results.
+ */
+
+/*
+ * A file read while parsing, and its identity at the time
+ * it was opened, such that it can be verified that the digest
+ * stored in the cache matches the contents actually parsed.
+ */
+struct	cdep {
+	char		*path;   /* File name relative to the cwd. */
+	dev_t		 dev;
+	ino_t		 ino;
+	off_t		 size;
+	struct timespec	 mtime;
+	int		 found;  /* The file could be opened. */
+	int		 known;  /* The identity is known. */
+};
+
+/*
+ * The result of converting one input document,
+ * either computed by the parser and formatter
+ * or retrieved from the cache.
+ */
+struct	centry {
+	char		*oname;  /* Output file name or NULL if empty. */
+	struct sink	 out;    /* Formatted output. */
+	struct sink	 msgs;   /* Messages for the standard error output. */
+	struct cdep	*deps;   /* Files read, starting with the input. */
+	size_t		 depsz;  /* Number of elements in deps. */
+	size_t		 depmax; /* Allocated size of deps. */
+	int		 rc;     /* Exit status for this document. */
+};
+
+void	 centry_init(struct centry *);
+void	 centry_adddep(struct centry *, const char *, int,
+		const struct stat *);
+void	 centry_free(struct centry *);
+
+char	*cache_readfile(const char *, size_t *, struct stat *);
+void	 cache_key(char *, const char *, const char *, const char *, size_t);
+int	 cache_get(const char *, const char *, struct centry *);
+void	 cache_put(const char *, const char *, const struct centry *);
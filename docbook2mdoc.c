@@ -18,12 +18,12 @@
 
 #include <assert.h>
 #include <ctype.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "xmalloc.h"
 #include "node.h"
+#include "sink.h"
 #include "macro.h"
 #include "format.h"
 
@@ -42,7 +42,7 @@ pnode_printtext(struct format *f, struct pnode *n)
 	int		 accept_arg;
 
 	para_check(f);
-	cp = n->b;
+	cp = n->u.b;
 	accept_arg = f->flags & FMT_ARG;
 	if (f->linestate == LINE_MACRO && !accept_arg &&
 	    (n->flags & NFLAG_SPC) == 0) {
@@ -51,7 +51,8 @@ pnode_printtext(struct format *f, struct pnode *n)
 				return;
 			if (strchr("!),.:;?]", *cp) == NULL)
 				break;
-			printf(" %c", *cp++);
+			sink_putc(f->out, ' ');
+			sink_putc(f->out, *cp++);
 		}
 		if (isspace((unsigned char)*cp)) {
 			while (isspace((unsigned char)*cp))
@@ -77,9 +78,9 @@ pnode_printtext(struct format *f, struct pnode *n)
 	 */
 
 	if ((f->nofill || f->linestate != LINE_MACRO) &&
-	    (nn = TAILQ_NEXT(n, child)) != NULL &&
+	    (nn = PNODE_NEXT(n)) != NULL &&
 	     (nn->flags & NFLAG_SPC) == 0) {
-		switch (pnode_class(nn->node)) {
+		switch (nn->class) {
 		case CLASS_LINE:
 		case CLASS_ENCL:
 			macro_open(f, "Pf");
@@ -98,10 +99,10 @@ pnode_printtext(struct format *f, struct pnode *n)
 	case LINE_TEXT:
 		if (n->flags & NFLAG_SPC) {
 			if (n->flags & NFLAG_LINE &&
-			    pnode_class(n->node) == CLASS_TEXT)
+			    n->class == CLASS_TEXT)
 				macro_close(f);
 			else
-				putchar(' ');
+				sink_putc(f->out, ' ');
 		}
 		break;
 	case LINE_MACRO:
@@ -116,14 +117,14 @@ pnode_printtext(struct format *f, struct pnode *n)
 				macro_close(f);
 		} else if (n->flags & NFLAG_SPC ||
 		    (f->flags & FMT_ARG) == 0 ||
-		    (nn = TAILQ_PREV(n, pnodeq, child)) == NULL ||
-		    pnode_class(nn->node) != CLASS_TEXT)
-			putchar(' ');
+		    (nn = PNODE_PREV(n)) == NULL ||
+		    nn->class != CLASS_TEXT)
+			sink_putc(f->out, ' ');
 		break;
 	}
 
 	if (n->node == NODE_ESCAPE) {
-		fputs(n->b, stdout);
+		sink_puts(f->out, n->u.b);
 		if (f->linestate == LINE_NEW)
 			f->linestate = LINE_TEXT;
 		return;
@@ -168,7 +169,7 @@ pnode_printrefnamediv(struct format *f, struct pnode *n)
 	macro_line(f, "Sh NAME");
 	f->parastate = PARA_HAVE;
 	comma = 0;
-	TAILQ_FOREACH_SAFE(nc, &n->childq, child, nn) {
+	PNODE_FOREACH_SAFE(nc, n, nn) {
 		if (nc->node != NODE_REFNAME)
 			continue;
 		if (comma)
@@ -189,7 +190,7 @@ pnode_printrefsynopsisdiv(struct format *f, struct pnode *n)
 {
 	struct pnode	*nc, *nn;
 
-	TAILQ_FOREACH_SAFE(nc, &n->childq, child, nn)
+	PNODE_FOREACH_SAFE(nc, n, nn)
 		if (nc->node == NODE_TITLE)
 			pnode_unlink(nc);
 
@@ -230,7 +231,7 @@ pnode_printsection(struct format *f, struct pnode *n)
 		abort();
 	}
 
-	TAILQ_FOREACH(nc, &n->childq, child)
+	PNODE_FOREACH(nc, n)
 		if (nc->node == NODE_TITLE)
 			break;
 
@@ -261,9 +262,9 @@ pnode_printsection(struct format *f, struct pnode *n)
 
 	if (nc != NULL) {
 		if (level == 1 &&
-		    (ncc = TAILQ_FIRST(&nc->childq)) != NULL &&
+		    (ncc = PNODE_FIRST(nc)) != NULL &&
 		    ncc->node == NODE_TEXT &&
-		    strcasecmp(ncc->b, "AUTHORS") == 0)
+		    strcasecmp(ncc->u.b, "AUTHORS") == 0)
 			macro_line(f, "An -nosplit");
 		pnode_unlink(nc);
 	}
@@ -279,7 +280,7 @@ pnode_printciterefentry(struct format *f, struct pnode *n)
 	struct pnode	*nc, *title, *manvol;
 
 	title = manvol = NULL;
-	TAILQ_FOREACH(nc, &n->childq, child) {
+	PNODE_FOREACH(nc, n) {
 		if (nc->node == NODE_MANVOLNUM)
 			manvol = nc;
 		else if (nc->node == NODE_REFENTRYTITLE)
@@ -308,16 +309,18 @@ pnode_printmathfenced(struct format *f, struct pnode *n)
 {
 	struct pnode	*nc;
 
-	printf("left %s ", pnode_getattr_raw(n, ATTRKEY_OPEN, "("));
+	sink_printf(f->out, "left %s ",
+	    pnode_getattr_raw(n, ATTRKEY_OPEN, "("));
 
-	nc = TAILQ_FIRST(&n->childq);
+	nc = PNODE_FIRST(n);
 	pnode_print(f, nc);
 
-	while ((nc = TAILQ_NEXT(nc, child)) != NULL) {
-		putchar(',');
+	while ((nc = PNODE_NEXT(nc)) != NULL) {
+		sink_putc(f->out, ',');
 		pnode_print(f, nc);
 	}
-	printf("right %s ", pnode_getattr_raw(n, ATTRKEY_CLOSE, ")"));
+	sink_printf(f->out, "right %s ",
+	    pnode_getattr_raw(n, ATTRKEY_CLOSE, ")"));
 	pnode_unlinksub(n);
 }
 
@@ -332,24 +335,24 @@ pnode_printmath(struct format *f, struct pnode *n)
 {
 	struct pnode	*nc;
 
-	nc = TAILQ_FIRST(&n->childq);
+	nc = PNODE_FIRST(n);
 	pnode_print(f, nc);
 
 	switch (n->node) {
 	case NODE_MML_MSUP:
-		fputs(" sup ", stdout);
+		sink_puts(f->out, " sup ");
 		break;
 	case NODE_MML_MFRAC:
-		fputs(" over ", stdout);
+		sink_puts(f->out, " over ");
 		break;
 	case NODE_MML_MSUB:
-		fputs(" sub ", stdout);
+		sink_puts(f->out, " sub ");
 		break;
 	default:
 		break;
 	}
 
-	nc = TAILQ_NEXT(nc, child);
+	nc = PNODE_NEXT(nc);
 	pnode_print(f, nc);
 	pnode_unlinksub(n);
 }
@@ -365,13 +368,12 @@ pnode_printfuncprototype(struct format *f, struct pnode *n)
 	 */
 
 	fdef = NULL;
-	TAILQ_FOREACH_SAFE(nc, &n->childq, child, nn) {
+	PNODE_FOREACH_SAFE(nc, n, nn) {
 		switch (nc->node) {
 		case NODE_FUNCDEF:
 			if (fdef == NULL) {
 				fdef = nc;
-				TAILQ_REMOVE(&n->childq, nc, child);
-				nc->parent = NULL;
+				pnode_unlink(nc);
 			}
 			break;
 		case NODE_VOID:
@@ -387,11 +389,11 @@ pnode_printfuncprototype(struct format *f, struct pnode *n)
 	 * Otherwise, use .Fo.
 	 */
 
-	nc = TAILQ_FIRST(&n->childq);
+	nc = PNODE_FIRST(n);
 	if (fdef != NULL) {
-		ftype = TAILQ_FIRST(&fdef->childq);
+		ftype = PNODE_FIRST(fdef);
 		if (ftype != NULL && ftype->node == NODE_TEXT) {
-			macro_argline(f, "Ft", ftype->b);
+			macro_argline(f, "Ft", ftype->u.b);
 			pnode_unlink(ftype);
 		}
 		if (nc == NULL) {
@@ -417,12 +419,12 @@ pnode_printfuncprototype(struct format *f, struct pnode *n)
 			macro_addarg(f, "(", ARG_QUOTED);
 			macro_addnode(f, fps, ARG_QUOTED);
 			macro_addarg(f, ")", ARG_QUOTED);
-			putchar('"');
+			sink_putc(f->out, '"');
 			macro_close(f);
 		} else
 			macro_nodeline(f, "Fa", nc, ARG_SINGLE);
 		pnode_unlink(nc);
-		nc = TAILQ_FIRST(&n->childq);
+		nc = PNODE_FIRST(n);
 	}
 	macro_line(f, "Fc");
 }
@@ -438,18 +440,13 @@ static void
 pnode_printarg(struct format *f, struct pnode *n)
 {
 	struct pnode	*nc;
-	struct pattr	*a;
+	enum attrval	 choice;
 	int		 isop, isrep, was_impl;
 
-	isop = 1;
-	isrep = was_impl = 0;
-	TAILQ_FOREACH(a, &n->attrq, child) {
-		if (a->key == ATTRKEY_CHOICE &&
-		    (a->val == ATTRVAL_PLAIN || a->val == ATTRVAL_REQ))
-			isop = 0;
-		else if (a->key == ATTRKEY_REP && a->val == ATTRVAL_REPEAT)
-			isrep = 1;
-	}
+	choice = pnode_getattr(n, ATTRKEY_CHOICE);
+	isop = choice != ATTRVAL_PLAIN && choice != ATTRVAL_REQ;
+	isrep = pnode_getattr(n, ATTRKEY_REP) == ATTRVAL_REPEAT;
+	was_impl = 0;
 	if (isop) {
 		if (f->flags & FMT_IMPL) {
 			was_impl = 1;
@@ -459,7 +456,7 @@ pnode_printarg(struct format *f, struct pnode *n)
 			f->flags |= FMT_IMPL;
 		}
 	}
-	TAILQ_FOREACH(nc, &n->childq, child) {
+	PNODE_FOREACH(nc, n) {
 		if (nc->node == NODE_TEXT)
 			macro_open(f, "Ar");
 		pnode_print(f, nc);
@@ -479,18 +476,13 @@ static void
 pnode_printgroup(struct format *f, struct pnode *n)
 {
 	struct pnode	*nc;
-	struct pattr	*a;
+	enum attrval	 choice;
 	int		 bar, isop, isrep, was_impl;
 
-	isop = 1;
-	isrep = was_impl = 0;
-	TAILQ_FOREACH(a, &n->attrq, child) {
-		if (a->key == ATTRKEY_CHOICE &&
-		    (a->val == ATTRVAL_PLAIN || a->val == ATTRVAL_REQ))
-			isop = 0;
-		else if (a->key == ATTRKEY_REP && a->val == ATTRVAL_REPEAT)
-			isrep = 1;
-	}
+	choice = pnode_getattr(n, ATTRKEY_CHOICE);
+	isop = choice != ATTRVAL_PLAIN && choice != ATTRVAL_REQ;
+	isrep = pnode_getattr(n, ATTRKEY_REP) == ATTRVAL_REPEAT;
+	was_impl = 0;
 	if (isop) {
 		if (f->flags & FMT_IMPL) {
 			was_impl = 1;
@@ -509,7 +501,7 @@ pnode_printgroup(struct format *f, struct pnode *n)
 		}
 	}
 	bar = 0;
-	TAILQ_FOREACH(nc, &n->childq, child) {
+	PNODE_FOREACH(nc, n) {
 		if (bar && f->linestate == LINE_MACRO)
 			macro_addarg(f, "|", ARG_SPACE);
 		pnode_print(f, nc);
@@ -559,7 +551,7 @@ pnode_printauthor(struct format *f, struct pnode *n)
 	 */
 
 	have_contrib = have_name = 0;
-	TAILQ_FOREACH_SAFE(nc, &n->childq, child, nn) {
+	PNODE_FOREACH_SAFE(nc, n, nn) {
 		switch (nc->node) {
 		case NODE_CONTRIB:
 			if (have_contrib)
@@ -575,7 +567,7 @@ pnode_printauthor(struct format *f, struct pnode *n)
 			break;
 		}
 	}
-	if (TAILQ_FIRST(&n->childq) == NULL)
+	if (PNODE_FIRST(n) == NULL)
 		return;
 
 	if (have_contrib)
@@ -588,7 +580,7 @@ pnode_printauthor(struct format *f, struct pnode *n)
 	 */
 
 	macro_open(f, "An");
-	TAILQ_FOREACH_SAFE(nc, &n->childq, child, nn) {
+	PNODE_FOREACH_SAFE(nc, n, nn) {
 		if (nc->node == NODE_PERSONNAME || have_name == 0) {
 			macro_addnode(f, nc, ARG_SPACE);
 			pnode_unlink(nc);
@@ -613,7 +605,7 @@ pnode_printauthor(struct format *f, struct pnode *n)
 	 * a text node follows that starts with closing punctuation.
 	 */
 
-	if (TAILQ_FIRST(&n->childq) != NULL) {
+	if (PNODE_FIRST(n) != NULL) {
 		macro_addarg(f, ",", ARG_SPACE);
 		macro_close(f);
 	}
@@ -639,8 +631,8 @@ pnode_printlink(struct format *f, struct pnode *n)
 
 	uri = pnode_getattr_raw(n, ATTRKEY_LINKEND, NULL);
 	if (uri != NULL) {
-		if (TAILQ_FIRST(&n->childq) != NULL) {
-			TAILQ_FOREACH(nc, &n->childq, child)
+		if (PNODE_FIRST(n) != NULL) {
+			PNODE_FOREACH(nc, n)
 				pnode_print(f, nc);
 			text = "";
 		} else if ((text = pnode_getattr_raw(n,
@@ -671,7 +663,7 @@ pnode_printlink(struct format *f, struct pnode *n)
 	if (uri != NULL) {
 		macro_open(f, "Lk");
 		macro_addarg(f, uri, ARG_SPACE | ARG_SINGLE);
-		if (TAILQ_FIRST(&n->childq) != NULL)
+		if (PNODE_FIRST(n) != NULL)
 			macro_addnode(f, n, ARG_SPACE | ARG_SINGLE);
 		pnode_unlinksub(n);
 	}
@@ -715,25 +707,24 @@ pnode_printprologue(struct format *f, struct pnode *root)
 {
 	struct pnode	*name, *nc;
 
-	nc = TAILQ_FIRST(&root->childq);
+	nc = PNODE_FIRST(root);
 	assert(nc->node == NODE_DATE);
 	macro_nodeline(f, "Dd", nc, 0);
 	pnode_unlink(nc);
 
 	macro_open(f, "Dt");
-	name = TAILQ_FIRST(&root->childq);
+	name = PNODE_FIRST(root);
 	assert(name->node == NODE_REFENTRYTITLE);
 	macro_addnode(f, name, ARG_SPACE | ARG_SINGLE | ARG_UPPER);
-	TAILQ_REMOVE(&root->childq, name, child);
-	name->parent = NULL;
-	nc = TAILQ_FIRST(&root->childq);
+	pnode_unlink(name);
+	nc = PNODE_FIRST(root);
 	assert (nc->node == NODE_MANVOLNUM);
 	macro_addnode(f, nc, ARG_SPACE | ARG_SINGLE);
 	pnode_unlink(nc);
 
 	macro_line(f, "Os");
 
-	nc = TAILQ_FIRST(&root->childq);
+	nc = PNODE_FIRST(root);
 	if (nc != NULL && nc->node == NODE_TITLE) {
 		macro_line(f, "Sh NAME");
 		macro_nodeline(f, "Nm", name, ARG_SINGLE);
@@ -758,7 +749,7 @@ pnode_printvarlistentry(struct format *f, struct pnode *n)
 	f->parastate = PARA_HAVE;
 	f->flags |= FMT_IMPL;
 	comma = -1;
-	TAILQ_FOREACH_SAFE(nc, &n->childq, child, nn) {
+	PNODE_FOREACH_SAFE(nc, n, nn) {
 		if (nc->node != NODE_TERM && nc->node != NODE_GLOSSTERM)
 			continue;
 		if (comma != -1) {
@@ -774,14 +765,14 @@ pnode_printvarlistentry(struct format *f, struct pnode *n)
 			}
 		}
 		f->parastate = PARA_HAVE;
-		comma = (ncc = TAILQ_FIRST(&nc->childq)) == NULL ||
-		    pnode_class(ncc->node) == CLASS_TEXT ? 0 : ARG_SPACE;
+		comma = (ncc = PNODE_FIRST(nc)) == NULL ||
+		    ncc->class == CLASS_TEXT ? 0 : ARG_SPACE;
 		pnode_print(f, nc);
 		pnode_unlink(nc);
 	}
 	macro_close(f);
 	f->parastate = PARA_HAVE;
-	while ((nc = TAILQ_FIRST(&n->childq)) != NULL) {
+	while ((nc = PNODE_FIRST(n)) != NULL) {
 		pnode_print(f, nc);
 		pnode_unlink(nc);
 	}
@@ -794,7 +785,7 @@ pnode_printtitle(struct format *f, struct pnode *n)
 {
 	struct pnode	*nc, *nn;
 
-	TAILQ_FOREACH_SAFE(nc, &n->childq, child, nn) {
+	PNODE_FOREACH_SAFE(nc, n, nn) {
 		if (nc->node == NODE_TITLE) {
 			if (f->parastate == PARA_MID)
 				f->parastate = PARA_WANT;
@@ -810,7 +801,7 @@ pnode_printrow(struct format *f, struct pnode *n)
 	struct pnode	*nc;
 
 	macro_line(f, "Bl -dash -compact");
-	TAILQ_FOREACH(nc, &n->childq, child) {
+	PNODE_FOREACH(nc, n) {
 		macro_line(f, "It");
 		pnode_print(f, nc);
 	}
@@ -897,7 +888,7 @@ pnode_printlist(struct format *f, struct pnode *n)
 	f->parastate = PARA_HAVE;
 	macro_argline(f, "Bl",
 	    n->node == NODE_ORDEREDLIST ? "-enum" : "-bullet");
-	TAILQ_FOREACH(nc, &n->childq, child) {
+	PNODE_FOREACH(nc, n) {
 		macro_line(f, "It");
 		f->parastate = PARA_HAVE;
 		pnode_print(f, nc);
@@ -916,7 +907,7 @@ pnode_printvariablelist(struct format *f, struct pnode *n)
 	pnode_printtitle(f, n);
 	f->parastate = PARA_HAVE;
 	macro_line(f, "Bl -tag -width Ds");
-	TAILQ_FOREACH(nc, &n->childq, child) {
+	PNODE_FOREACH(nc, n) {
 		if (nc->node == NODE_VARLISTENTRY)
 			pnode_printvarlistentry(f, nc);
 		else
@@ -981,7 +972,7 @@ pnode_print(struct format *f, struct pnode *n)
 		break;
 	case NODE_COPYRIGHT:
 		print_text(f, "Copyright", ARG_SPACE);
-		fputs(" \\(co", stdout);
+		sink_puts(f->out, " \\(co");
 		break;
 	case NODE_EDITOR:
 		print_text(f, "editor:", ARG_SPACE);
@@ -998,8 +989,8 @@ pnode_print(struct format *f, struct pnode *n)
 	case NODE_EMPHASIS:
 	case NODE_FIRSTTERM:
 	case NODE_GLOSSTERM:
-		if ((nc = TAILQ_FIRST(&n->childq)) != NULL &&
-		    pnode_class(nc->node) < CLASS_LINE)
+		if ((nc = PNODE_FIRST(n)) != NULL &&
+		    nc->class < CLASS_LINE)
 			macro_open(f, "Em");
 		if (n->node == NODE_GLOSSTERM)
 			f->parastate = PARA_HAVE;
@@ -1077,9 +1068,9 @@ pnode_print(struct format *f, struct pnode *n)
 	case NODE_MML_MI:
 	case NODE_MML_MN:
 	case NODE_MML_MO:
-		if (TAILQ_EMPTY(&n->childq))
+		if (PNODE_EMPTY(n))
 			break;
-		fputs(" { ", stdout);
+		sink_puts(f->out, " { ");
 		break;
 	case NODE_MML_MFRAC:
 	case NODE_MML_MSUB:
@@ -1090,8 +1081,8 @@ pnode_print(struct format *f, struct pnode *n)
 		pnode_printolink(f, n);
 		break;
 	case NODE_OPTION:
-		if ((nc = TAILQ_FIRST(&n->childq)) != NULL &&
-		    pnode_class(nc->node) < CLASS_LINE)
+		if ((nc = PNODE_FIRST(n)) != NULL &&
+		    nc->class < CLASS_LINE)
 			macro_open(f, "Fl");
 		break;
 	case NODE_ORDEREDLIST:
@@ -1109,9 +1100,9 @@ pnode_print(struct format *f, struct pnode *n)
 		pnode_unlinksub(n);
 		break;
 	case NODE_QUOTE:
-		if ((nc = TAILQ_FIRST(&n->childq)) != NULL &&
+		if ((nc = PNODE_FIRST(n)) != NULL &&
 		    nc->node == NODE_FILENAME &&
-		    TAILQ_NEXT(nc, child) == NULL) {
+		    PNODE_NEXT(nc) == NULL) {
 			if (n->flags & NFLAG_SPC)
 				nc->flags |= NFLAG_SPC;
 		} else if (was_impl)
@@ -1162,12 +1153,12 @@ pnode_print(struct format *f, struct pnode *n)
 			macro_addarg(f, "_", 0);
 		else
 			print_text(f, "_", 0);
-		if ((nc = TAILQ_FIRST(&n->childq)) != NULL)
+		if ((nc = PNODE_FIRST(n)) != NULL)
 			nc->flags &= ~(NFLAG_LINE | NFLAG_SPC);
 		break;
 	case NODE_SUPERSCRIPT:
-		fputs("\\(ha", stdout);
-		if ((nc = TAILQ_FIRST(&n->childq)) != NULL)
+		sink_puts(f->out, "\\(ha");
+		if ((nc = PNODE_FIRST(n)) != NULL)
 			nc->flags &= ~(NFLAG_LINE | NFLAG_SPC);
 		break;
 	case NODE_TEXT:
@@ -1209,10 +1200,10 @@ pnode_print(struct format *f, struct pnode *n)
 		break;
 	}
 
-	if (pnode_class(n->node) == CLASS_NOFILL)
+	if (n->class == CLASS_NOFILL)
 		f->nofill++;
 
-	TAILQ_FOREACH(nc, &n->childq, child)
+	PNODE_FOREACH(nc, n)
 		pnode_print(f, nc);
 
 	switch (n->node) {
@@ -1252,7 +1243,7 @@ pnode_print(struct format *f, struct pnode *n)
 			f->flags &= ~FMT_IMPL;
 		break;
 	case NODE_MEMBER:
-		if ((nn = TAILQ_NEXT(n, child)) != NULL &&
+		if ((nn = PNODE_NEXT(n)) != NULL &&
 		    nn->node != NODE_MEMBER)
 			nn = NULL;
 		switch (f->linestate) {
@@ -1273,18 +1264,18 @@ pnode_print(struct format *f, struct pnode *n)
 	case NODE_MML_MI:
 	case NODE_MML_MN:
 	case NODE_MML_MO:
-		if (TAILQ_EMPTY(&n->childq))
+		if (PNODE_EMPTY(n))
 			break;
-		fputs(" } ", stdout);
+		sink_puts(f->out, " } ");
 		break;
 	case NODE_PARA:
 		if (f->parastate == PARA_MID)
 			f->parastate = PARA_WANT;
 		break;
 	case NODE_QUOTE:
-		if ((nc = TAILQ_FIRST(&n->childq)) != NULL &&
+		if ((nc = PNODE_FIRST(n)) != NULL &&
 		    nc->node == NODE_FILENAME &&
-		    TAILQ_NEXT(nc, child) == NULL)
+		    PNODE_NEXT(nc) == NULL)
 			/* nothing */;
 		else if (was_impl) {
 			f->flags &= ~FMT_NOSPC;
@@ -1313,32 +1304,33 @@ pnode_print(struct format *f, struct pnode *n)
 		f->parastate = PARA_WANT;
 		break;
 	case NODE_YEAR:
-		if ((nn = TAILQ_NEXT(n, child)) != NULL &&
+		if ((nn = PNODE_NEXT(n)) != NULL &&
 		    nn->node == NODE_YEAR &&
 		    f->linestate == LINE_TEXT) {
 			print_text(f, ",", 0);
 			nn->flags |= NFLAG_SPC;
-			if ((nc = TAILQ_FIRST(&nn->childq)) != NULL)
+			if ((nc = PNODE_FIRST(nn)) != NULL)
 				nc->flags |= NFLAG_SPC;
 		}
 	default:
 		break;
 	}
 	f->flags &= ~FMT_ARG;
-	if (pnode_class(n->node) == CLASS_NOFILL)
+	if (n->class == CLASS_NOFILL)
 		f->nofill--;
 }
 
 void
-ptree_print_mdoc(struct ptree *tree)
+ptree_print_mdoc(struct ptree *tree, struct sink *out)
 {
 	struct format	 formatter;
 
+	formatter.out = out;
 	formatter.level = formatter.nofill = 0;
 	formatter.linestate = LINE_NEW;
 	formatter.parastate = PARA_HAVE;
 	pnode_printprologue(&formatter, tree->root);
 	pnode_print(&formatter, tree->root);
 	if (formatter.linestate != LINE_NEW)
-		putchar('\n');
+		sink_putc(out, '\n');
 }
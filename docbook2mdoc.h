@@ -0,0 +1,65 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * The public interface of the docbook2mdoc library.
+ *
+ * A document is converted in stages: d2m_parse() parses it from
+ * memory or d2m_parse_file() from a file, d2m_reorg() reorganizes
+ * the parse tree, and d2m_render() formats it into a newly allocated
+ * buffer.  Parser messages are collected with the document rather
+ * than printed.
+ * Documents parsed with the same cache from d2m_cache_alloc() reuse
+ * the parse trees of included files that did not change.  A cache
+ * has to be freed after all its documents, and a cache and its
+ * documents must not be used by more than one thread at a time.
+ * Running out of memory terminates the program with exit status 6.
+ */
+
+#define	D2M_WARNING	2  /* Message level of warnings. */
+#define	D2M_ERROR	3  /* Message level of errors. */
+
+/* Flags for d2m_parse() and d2m_parse_file(). */
+#define	D2M_WARN	(1 << 0)  /* Report warnings, too. */
+
+enum	d2m_outt {
+	D2M_MDOC,  /* Manual page in mdoc(7) format. */
+	D2M_TREE   /* Parse tree for debugging. */
+};
+
+struct	d2m_msg {
+	char		*fname;  /* Name of the input file. */
+	char		*text;   /* Message text. */
+	int		 line;   /* Line number in the input file. */
+	int		 col;    /* Column number in the input file. */
+	int		 level;  /* D2M_WARNING or D2M_ERROR. */
+};
+
+struct	d2m_cache;  /* Opaque object; used only in lib.c. */
+struct	d2m_doc;  /* Opaque object; used only in lib.c. */
+
+struct d2m_cache	*d2m_cache_alloc(void);
+void			 d2m_cache_free(struct d2m_cache *);
+struct d2m_doc		*d2m_parse(struct d2m_cache *,
+				const char *, size_t, const char *, int);
+struct d2m_doc		*d2m_parse_file(struct d2m_cache *,
+				const char *, int);
+void			 d2m_reorg(struct d2m_doc *, const char *);
+char			*d2m_render(struct d2m_doc *, enum d2m_outt, size_t *);
+const struct d2m_msg	*d2m_msgs(const struct d2m_doc *, size_t *);
+int			 d2m_status(const struct d2m_doc *);
+void			 d2m_free(struct d2m_doc *);
@@ -0,0 +1,592 @@
+/* This file is generated by mkhash from entities.h. */
+
+static	const unsigned char entitydisp[2048] = {
+	  3,   2,   0,   0,   2,   2,   1,   1,   1,   1,   1,   0,
+	  1,   1,   0,   1,   1,   2,   1,   2,   1,   0,   0,   1,
+	  0,   1,   1,   1,   1,   0,   0,   2,   0,   0,   2,   1,
+	  1,   2,   0,   2,   3,   0,   1,   1,   0,   0,   1,   1,
+	  1,   0,   1,   2,   1,   2,   0,   0,   1,   1,   0,   1,
+	  4,   0,   1,   0,   1,   1,   1,   1,   1,   0,   2,   0,
+	  1,   1,   2,   0,   0,   1,   0,   2,   1,   2,   2,   3,
+	  1,   0,   1,   0,   1,   1,   2,   0,   1,   2,   1,   0,
+	  1,   3,   0,   1,   2,   0,   3,   1,   0,   1,   1,   1,
+	  3,   2,   0,   2,   0,   1,   0,   1,   0,   2,   4,   1,
+	  0,   1,   0,   1,   1,   2,   4,   1,   0,   0,   4,   2,
+	  0,   0,   0,   3,   1,   0,   1,   1,   0,   0,   1,   1,
+	  1,   0,   2,   1,   1,   1,   1,   1,   1,   2,   1,   3,
+	  1,   1,   1,   0,   1,   0,   0,   1,   1,   1,   3,   1,
+	  0,   0,   0,   1,   0,   1,   0,   1,   0,   1,   1,   1,
+	  1,   2,   1,   1,   1,   0,   1,   0,   1,   0,   1,   0,
+	  0,   0,   1,   1,   1,   1,   0,   0,   0,   2,   0,   0,
+	  2,   3,   1,   1,   1,   1,   1,   1,   0,   0,   1,   1,
+	  1,   2,   1,   1,   2,   1,   0,   3,   0,   1,   1,   0,
+	  1,   1,   1,   0,   0,   2,   0,   1,   1,   4,   1,   1,
+	  1,   1,   2,   2,   0,   0,   1,   1,   0,   2,   0,   0,
+	  0,   0,   3,   1,   0,   0,   2,   2,   1,   1,   1,   0,
+	  1,   2,   1,   1,   0,   1,   0,   1,   0,   0,   0,   1,
+	  2,   1,   1,   0,   0,   0,   0,   2,   1,   1,   0,   1,
+	  0,   1,   1,   0,   1,   2,   0,   3,   0,   2,   0,   1,
+	  1,   0,   1,   1,   1,   0,   1,   1,   0,   0,   0,   0,
+	  1,   0,   3,   0,   0,   0,   0,   1,   1,   0,   0,   3,
+	  2,   0,   1,   2,   1,   0,   0,   0,   2,   0,   0,   1,
+	  0,   0,   2,   2,   1,   1,   0,   0,   2,   4,   1,   0,
+	  1,   2,   0,   1,   1,   1,   3,   0,   0,   1,   0,   4,
+	  3,   1,   1,   1,   2,   0,   1,   1,   1,   0,   2,   1,
+	  1,   1,   0,   1,   4,   4,   0,   1,   1,   2,   0,   1,
+	  0,   1,   1,   2,   0,   1,   2,   0,   0,   1,   1,   0,
+	  3,   2,   2,   0,   1,   3,   0,   7,   0,   2,   0,   0,
+	  2,   1,   1,   1,   0,   0,   2,   1,   1,   2,   1,   1,
+	  0,   1,   1,   0,   1,   4,   1,   0,   1,   1,   1,   0,
+	  0,   1,   1,   1,   3,   1,   0,   1,   2,   1,   3,   1,
+	  0,   1,   1,   1,   0,   0,   0,   1,   1,   0,   2,   0,
+	  1,   1,   0,   1,   1,   2,   1,   2,   0,   1,   1,   2,
+	  1,   4,   1,   2,   2,   1,   0,   2,   1,   1,   2,   0,
+	  3,   1,   0,   1,   0,   1,   1,   1,   1,   1,   2,   1,
+	  0,   1,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,
+	  1,   1,   0,   1,   4,   0,   1,   1,   0,   0,   1,   1,
+	  1,   2,   1,   1,   0,   4,   1,   2,   0,   0,   2,   0,
+	  0,   1,   0,   2,   2,   1,   0,   0,   0,   1,   1,   1,
+	  1,   1,   1,   0,   0,   1,   1,   1,   0,   2,   1,   1,
+	  4,   1,   0,   0,   2,   2,   1,   0,   1,   0,   1,   0,
+	  1,   1,   1,   1,   1,   0,   2,   1,   0,   2,   1,   0,
+	  1,   1,   1,   1,   2,   0,   1,   2,   2,   1,   3,   0,
+	  3,   1,   0,   1,   1,   0,   0,   1,   0,   0,   1,   1,
+	  3,   4,   1,   0,   0,   4,   2,   1,   0,   0,   0,   1,
+	  0,   1,   3,   1,   3,   1,   0,   0,   1,   1,   0,   0,
+	  2,   1,   0,   1,   2,   2,   1,   0,   0,   0,   3,   0,
+	  2,   0,   0,   1,   0,   1,   0,   1,   1,   0,   0,   0,
+	  0,   2,   2,   1,   1,   1,   1,   2,   1,   0,   2,   0,
+	  1,   0,   0,   1,   1,   0,   0,   1,   1,   3,   2,   2,
+	  1,   1,   0,   1,   0,   0,   0,   0,   5,   0,   0,   1,
+	  2,   1,   1,   3,   1,   1,   0,   0,   0,   1,   0,   1,
+	  0,   0,   0,   0,   1,   0,   1,   2,   2,   3,   0,   0,
+	  1,   1,   1,   1,   1,   2,   1,   0,   1,   1,   0,   1,
+	  0,   1,   2,   1,   1,   2,   0,   1,   1,   1,   3,   1,
+	  1,   0,   0,   2,   1,   2,   1,   2,   1,   1,   1,   0,
+	  2,   2,   1,   2,   2,   0,   2,   0,   0,   0,   1,   1,
+	  1,   3,   1,   1,   4,   0,   0,   0,   0,   2,   2,   1,
+	  0,   0,   0,   0,   0,   1,   2,   2,   0,   1,   1,   0,
+	  0,   0,   1,   0,   0,   0,   0,   1,   1,   0,   1,   1,
+	  1,   2,   2,   0,   0,   0,   2,   1,   1,   0,   1,   1,
+	  0,   0,   0,   1,   0,   1,   1,   1,   0,   1,   1,   1,
+	  0,   8,   1,   1,   1,   2,   1,   1,   1,   0,   3,   2,
+	  1,   0,   0,   1,   1,   2,   1,   0,   1,   1,   2,   0,
+	  4,   1,   3,   0,   2,   1,   0,   4,   0,   2,   0,   1,
+	  0,   1,   1,   0,   0,   1,   4,   1,   0,   1,   1,   0,
+	  1,   1,   0,   0,   2,   0,   1,   0,   1,   2,   0,   2,
+	  1,   0,   3,   3,   1,   1,   0,   0,   1,   0,   1,   2,
+	  3,   1,   0,   0,   1,   1,   1,   4,   1,   0,   1,   0,
+	  1,   2,   1,   0,   1,   0,   0,   1,   0,   1,   0,   1,
+	  1,   1,   0,   1,   0,   0,   1,   1,   1,   0,   4,   2,
+	  0,   2,   1,   0,   1,   3,   0,   0,   1,   7,   0,   1,
+	  4,   2,   1,   1,   1,   1,   1,   0,   1,   0,   0,   0,
+	  3,   1,   0,   1,   4,   1,   0,   3,   0,   2,   0,   0,
+	  2,   3,   2,   2,   3,   0,   2,   1,   1,   1,   0,   2,
+	  1,   0,   0,   0,   1,   1,   0,   0,   1,   0,   0,   2,
+	  3,   3,   5,   1,   0,   0,   1,   0,   0,   1,   1,   0,
+	  1,   2,   3,   0,   0,   2,   1,   1,   1,   1,   2,   0,
+	  0,   0,   0,   3,   0,   0,   1,   4,   1,   1,   0,   1,
+	  3,   0,   1,   1,   0,   1,   2,   1,   1,   0,   0,   0,
+	  0,   2,   1,   0,   0,   0,   2,   0,   0,   2,   2,   1,
+	  0,   1,   0,   3,   1,   1,   1,   2,   0,   1,   1,   5,
+	  1,   2,   0,   1,   2,   1,   0,   0,   0,   1,   0,   0,
+	  0,   0,   0,   1,   1,   1,   1,   0,   1,   0,   0,   0,
+	  3,   2,   1,   5,   0,   1,   1,   1,   0,   1,   1,   2,
+	  0,   4,   1,   1,   2,   2,   1,   1,   3,   0,   3,   1,
+	  0,   0,   0,   2,   1,   2,   1,   1,   0,   2,   0,   2,
+	  0,   1,   0,   1,   2,   0,   1,   1,   0,   2,   1,   0,
+	  3,   2,   2,   1,   1,   1,   1,   1,   2,   0,   3,   1,
+	  0,   3,   0,   1,   2,   1,   3,   0,   0,   1,   0,   4,
+	  0,   1,   0,   0,   0,   2,   0,   1,   2,   2,   0,   1,
+	  0,   0,   4,   0,   0,   4,   0,   0,   0,   1,   4,   1,
+	  1,   1,   0,   1,   0,   1,   1,   1,   0,   2,   4,   0,
+	  1,   1,   1,   1,   1,   3,   3,   2,   1,   2,   0,   1,
+	  1,   0,   2,   2,   1,   2,   2,   3,   0,   0,   1,   1,
+	  1,   0,   2,   1,   1,   1,   1,   4,   1,   1,   0,   3,
+	  2,   1,   1,   0,   0,   5,   2,   0,   1,   2,   2,   0,
+	  3,   0,   2,   9,   2,   0,   3,   3,   0,   1,   2,   1,
+	  1,   0,   2,   3,   1,   4,   6,   2,   2,   3,   3,   0,
+	  2,   0,   2,   0,   1,   1,   0,   1,   2,   0,   1,   0,
+	  1,   2,   0,   3,   2,   2,   0,   0,   2,   2,   1,   1,
+	  1,   1,   1,   0,   4,   0,   1,   5,   2,   4,   2,   0,
+	  1,   0,   0,   0,   1,   1,   1,   1,   1,   1,   1,   2,
+	  0,   1,   1,   1,   0,   3,   3,   1,   1,   0,   1,   0,
+	  0,   0,   1,   0,   0,   1,   1,   0,   4,   1,   1,   3,
+	  0,   1,   2,   0,   2,   0,   0,   2,   0,   1,   1,   0,
+	  2,   1,   0,   1,   1,   5,   1,   1,   2,   7,   3,   2,
+	  2,   3,   1,   1,   0,   1,   1,   1,   1,   2,   0,   1,
+	  2,   1,   0,   2,   0,   0,   2,   1,   0,   3,   3,   3,
+	  0,   1,   0,   2,   0,   0,   0,   1,   3,   0,   0,   0,
+	  0,   1,   1,   1,   1,   3,   0,   2,   1,   3,   1,   0,
+	  1,   2,   0,   0,   2,   1,   0,   0,   3,   1,   2,   0,
+	  0,   3,   0,   0,   0,   0,   0,   2,   1,   1,   1,   0,
+	  1,   2,   1,   1,   0,   0,   0,   1,   0,   1,   0,   0,
+	  0,   0,   3,   2,   1,   2,   8,   3,   0,   0,   2,   0,
+	  0,   2,   0,   0,   0,   0,   0,   1,   2,   3,   0,   0,
+	  0,   5,   1,   1,   1,   0,   1,   1,   1,   0,   0,   2,
+	  2,   4,   6,   1,   1,   1,   3,   0,   1,   2,   1,   2,
+	  1,   1,   0,   0,   5,   0,   1,   0,   0,   0,   2,   0,
+	  1,   1,   2,   1,   0,   0,   1,   0,   0,   0,   1,   0,
+	  0,   3,   0,   1,   1,   1,   0,   0,   1,   0,   1,   0,
+	  1,   1,   0,   0,   1,   0,   2,   0,   3,   2,   2,   0,
+	  1,   0,   1,   1,   3,   1,   0,   3,   0,   0,   4,   3,
+	  1,   1,   0,   0,   1,   0,   2,   2,   1,   1,   4,   0,
+	  1,   1,   1,   0,   2,   0,   0,   1,   2,   3,   1,   0,
+	  2,   3,   0,   1,   4,   0,   0,   1,   0,   0,   1,   1,
+	  0,   2,   0,   2,   3,   1,   0,   1,   1,   1,   1,   1,
+	  0,   3,   1,   0,   0,   0,   1,   2,   1,   0,   1,   2,
+	  3,   1,   1,   1,   1,   1,   0,   0,   0,   0,   0,   0,
+	  2,   1,   1,   0,   0,   0,   0,   1,   2,   2,   1,   1,
+	  0,   0,   1,   2,   1,   1,   1,   1,   0,   0,   1,   0,
+	  1,   0,   0,   2,   1,   1,   1,   0,   2,   0,   1,   1,
+	  0,   1,   2,   1,   4,   1,   4,   7,   3,   0,   0,   2,
+	  1,   0,   0,   1,   1,   0,   0,   4,   0,   2,   1,   2,
+	  0,   5,   2,   0,   0,   1,   1,   1,   0,   2,   0,   1,
+	  1,   1,   4,   0,   0,   2,   0,   2,   1,   0,   0,   1,
+	  2,   0,   0,   0,   0,   0,   0,   0,   3,   0,   1,   0,
+	  3,   0,   0,   0,   0,   0,   0,   2,   3,   1,   0,   1,
+	  1,   4,   4,   0,   1,   0,   0,   1,   1,   0,   1,   5,
+	  4,   2,   2,   1,   2,   5,   1,   1,   0,   1,   1,   0,
+	  2,   4,   2,   0,   1,   4,   1,   1,   0,   2,   2,   0,
+	  0,   1,   0,   2,   0,   1,   1,   0,   3,   0,   0,   1,
+	  0,   1,   3,   1,   2,   2,   2,   0,   1,   1,   1,   0,
+	  1,   1,   1,   0,   0,   0,   8,   1,   0,   2,   1,   1,
+	  1,   3,   0,   2,   0,   1,   4,   5,   2,   1,   2,   0,
+	  1,   3,   2,   1,   1,   0,   0,   2,   0,   0,   0,   6,
+	  0,   2,   1,   3,   3,   1,   0,   1,   0,   0,   0,   1,
+	  0,   1,   1,   1,   1,   0,   1,   2,   1,   0,   2,   1,
+	  1,   1,   0,   0,   1,   4,   1,   0,   0,   2,   1,   1,
+	  4,   3,   0,   1,   0,   1,   0,   1,   0,   2,   0,   1,
+	  0,   1,   3,   1,   0,   2,   1,   1,   1,   0,   1,   0,
+	  0,   0,   4,   1,   0,   2,   1,   2,   0,   1,   0,   0,
+	  1,   1,   5,   4,   2,   0,   0,   1,   0,   2,   0,   1,
+	  2,   1,   2,   0,   0,   1,   2,   4,   0,   0,   0,   1,
+	  1,   0,   1,   0,   2,   2,   0,   1,   1,   0,   1,   2,
+	  0,   2,   0,   2,   2,   0,   5,   1,   0,   0,   0,   2,
+	  3,   3,   1,   9,   1,   1,   2,   0,   1,   2,   1,   1,
+	  2,   0,   0,   1,   1,   0,   1,   3,   1,   3,   4,   1,
+	  0,   0,   1,   2,   4,   5,   1,   0,   1,   0,   4,   0,
+	  2,   1,   0,   0,   0,   0,   3,   5,   1,   2,   0,   2,
+	  1,   3,   0,   2,   1,   3,   1,   2,   1,   0,   1,   1,
+	  2,   2,   2,   3,   2,   2,   0,   1,   2,   1,   0,   0,
+	  1,   0,   0,   1,   2,   4,   1,   3,   0,   4,   1,   2,
+	  1,   0,   2,   1,   2,   3,   3,   2,   0,   1,   0,   1,
+	  1,   2,   1,   3,   0,   1,   0,   6
+};
+
+static	const unsigned short entityslot[4096] = {
+	   0, 2072,    0,  367, 1714, 1027,    0,    0,  609,    0,
+	 758,    0, 1121,  176,  762, 1904,  401,  146,    0,  552,
+	 177,    0,    0,    0,    0,    0, 1318,    0,    0,  537,
+	   0,    0, 1097,    0,  459, 1620,   92,    0, 1811,    0,
+	1794, 1024,  331,    0, 1004,  166, 1784, 1635, 1833, 1516,
+	1771,    0,    0, 1228,    0,    0,  170,    0,    0,    0,
+	 521,    0,    0,    0,    0,  619,    0,    0,  557,    0,
+	1356,    0, 1215,    0,    0,    0,    0,    0,  710,    0,
+	 801,    0, 1114,    0,    0,    0,  193,    0, 1118,  279,
+	   0,    0,  745, 1800, 1744, 1285,    0, 1023, 1387, 1865,
+	1760,  344,    0,    0,    0,  630,    0,    0,  743, 1520,
+	   0,    0, 1014,  396,  925, 2051,    0,    0,    0,    0,
+	  33,    0,  929,  224,  598,    0,    0,    0,  518,    0,
+	   0,  201,    0,    0, 1444, 1265,    0,    0, 1146,  931,
+	  79,    0,  950,    0,  517, 1913,  754,  798,    0,    0,
+	   0,    0,    0,  756, 2030,    0, 1003,    0,    0,    0,
+	   0,    0, 1120,    0,    0,  479,    0, 1984,  356,    0,
+	   0,  671, 1250,    0,    0,    0, 1647,    0,  694, 1190,
+	 873, 1274,    0, 1137,    0,    0, 1973,  989, 1932, 1998,
+	   0,    0,    0,  246,  964, 1747,    0,  386,    0,    0,
+	   0,    0,  859,  509,    0,  943, 1558,    0, 1132,    0,
+	 909,  770,    0,    0,  198,    0, 1443,    0,    0,  817,
+	 253,  197,    0, 1538,    0, 1301,    0,    0, 2037,  257,
+	   0,  120,  858, 2055,    0,  194, 2063, 1254,    0, 1105,
+	1962,    0, 1210,    0, 1930,    0,    0,    0, 1876,  788,
+	1952,    0,    0,    0, 1072, 1400, 1597,    0,    0,    0,
+	1222,    0, 1279,    0,    0,    0, 1397, 1212,    0, 1963,
+	   0,    0,  526, 1407,    0,  624,    0,    0,    0, 1098,
+	1828, 1246, 1783,    0,    0,    0,  972,    0, 1257,  942,
+	1441,    0, 1537, 1464,    0,    0,    0, 1101,    0,  501,
+	1268,  438,    0,  377,  626,   77,    0,  435,  917,  476,
+	1308,  316, 1859,  880, 1951,    0,   44,    0, 1591, 1879,
+	2105, 1082,    0, 1380,    0,    0,    0,   39,    0,  791,
+	 171,    0,    0,    0,    0,  387,    0,    0, 1934,    0,
+	1300, 1203, 1191,    0,  780,  233, 1410,  947,    0,    0,
+	   0, 1853,   12,    0,  560,  665, 1870,  341, 2057,    0,
+	   0, 1312,    0,  568, 1245,  781, 2110,  757, 1174,    0,
+	   0,  281, 1090, 1821,    0,    0,    0,    0,  136, 1891,
+	 995,    0,    0,    0,  895,    0, 2107,    0, 1309,  579,
+	   0,    0,    0,  540,    0, 1491, 1852, 1155,    0,    0,
+	   0, 1260,    0,    0, 1009, 1481,    0, 1175, 1061,  450,
+	1883,    0,  631, 1208,  301,    0,  827, 1721,  407,  141,
+	 876, 2011, 1467,    0,  425, 1576,    0,    0, 1607, 1472,
+	 299,   71,    0,   22,    0,    0, 1549, 1884,    0, 1463,
+	1777,  620,    0,    0,    0, 1518,  702,  373, 1038,  669,
+	 319, 1532,    0,    0,  953,    0,    0,    0,    0, 1131,
+	 206,    0,    0,    0,    0,  127,    0,    0, 1346,    0,
+	1117, 2093,  687,    0,    0, 1924, 1779,    0,  324,    0,
+	   0,    0,  520, 1110,  153,  355,    0,    0,  949, 1975,
+	1997,    0,    0,    0,    0, 1700,    0,    0,    0,   90,
+	   0,    0, 1600, 1706,  259,  559, 1581, 1867,    0,    0,
+	   0,    0,    0, 1389,    0, 1762,  808, 1296,    0, 1645,
+	   0,    0, 1028,    0,    0,    0, 1070,    0,  930, 1251,
+	   0, 1054,    0,    0,    0,    0,    0,  538, 1122,    0,
+	  38,    0,  290, 1863,    0,    0,    0,  231,    0,    0,
+	 339,  421,    0,  577,    0,    0,    0,  997,    0,    0,
+	1882,    0,    0,    0,    0,    0,  277,    0,    0,    0,
+	   0,    0,    0,    0,    0,    0, 1473,    0, 2104,    0,
+	1797,  935,  793,    0,    0,    0, 1599, 1555, 1831,    0,
+	   0,    0,    0,    0,  543,    0,    0,  217,    0,  403,
+	   0,    0,    0,  747,    0,    0, 1015, 1344,  395,    0,
+	   0,  767,    0,    0, 1381,    0,    0,  811,  625,  523,
+	 349, 2076,    0,    0, 1099,    0,  360, 1678, 1685, 1939,
+	   0,    0,  254,    0, 1995, 1447,    0,  675,  981,    0,
+	   3, 1319,  853,    0, 1459,  906,    0,    0,    0, 1860,
+	   0, 1437,    0, 1878,  131, 1232, 1226,    0, 1142,    0,
+	   0, 1153,    0, 1986,  274,    0,    0,    0, 1713,    0,
+	   0, 1448,  807, 1353, 1603,  698,    0,    0,  591,    0,
+	   0,    0,  234,  487, 1682,    0,    0, 2000, 1750,    0,
+	   0,    0, 1478,    0,    0,  333,    0,    0,    0,    0,
+	   0,    0,  126,    0, 1320,  357,    0,    0,    0, 1640,
+	 330,    0,    0, 1095,    0,  714,    0,  576,    0,    0,
+	   0, 2074,    0,  590,   58,  799,  861,    0, 1561, 1536,
+	1941,    0,    0,    0,    0, 1844,    0,  148,  456,  362,
+	 642,  934,    0, 2061,    0,  491,   87, 1385,  595, 1331,
+	1841,    0,    0,    0, 1627,    0,    0,    0,    0, 1305,
+	 205, 1255, 1359, 2090,    0,  524,  970,    0, 1728,    0,
+	   0,    0, 1424, 1923, 1694, 1944,   98,  656,  954,    0,
+	1920,  192,  271, 1181,    0,    0,    0,  975, 1705, 1531,
+	1332,   67,    0, 1492,  555,    0,  607,    0, 1751,    0,
+	1758,    0, 1103,  818, 1638,    0,  690, 1658,    0,    0,
+	   0, 1273,    0,    0,    0, 1074,    0,  966,    0, 1687,
+	 329,    0,    0,    0,    0,    0,    0,  659,    0,    0,
+	   0,    0, 1615,    0,    0,    0,   18, 1073,    0,    0,
+	   0, 1671,    0, 2097,  123,    0, 2012,  272, 1972,    0,
+	   0,    0,    0, 1207, 1012,    0,  199,    0, 1770,    0,
+	   0,    0,    0,  439,    0,    0,    0,    0,    0, 1525,
+	   0,  653,    0,   81, 1306,    0,   25,  156,    0,    0,
+	1451, 1588,    0,    0,    0,    0, 1471, 1440,    0,  688,
+	   0,  427,    0,    0,  908,  933,  813,    0,    0,  414,
+	1613, 1890,    0,  554,  308,    0,  812,    0,    0,    0,
+	   0,    0,   19,    0,  809,    0, 1967,    0, 1091,    0,
+	   0,    0,  629,    0,    0,    0, 1485,    0, 1738,    0,
+	   0, 1874,    0, 1582, 1177,    0,    0, 1643,    0,    0,
+	 589,  944,    0,    0,    0,  454, 1568,    0,  215,  901,
+	1041,  138, 2010, 1002,    0,    0,    0,    0,   76,    0,
+	 462,    0,    0, 1294,    0,    0,    0,  525,    0,  973,
+	1535,  506, 1812,  212, 1499,  546,    0,    0,    0, 1366,
+	   0,    0,  530, 1723, 2008,    0,    0,  753,    0, 1414,
+	   0, 2091,    0,  181,    0,    0,    0,    0,    0, 1580,
+	1715,  643,    0,  410,    0,  819,    0,  565,  742,    0,
+	2108,  603,    0,    0,    0,    0, 1042,    0, 1938,    0,
+	 443,  938, 1337, 1278, 2125,  599, 1766,  496,  849,    0,
+	 413,  905,    0, 2121,    0,    0, 2113,    0,   49, 1416,
+	1843, 1916,    0, 1829, 1677, 2119,  768,    0, 2102, 1075,
+	   0,    0,  343,    0,    0,  340, 1352,    0,    0, 2052,
+	   0,    0,    0,    0, 2114, 1066,    0, 1574, 1825,    0,
+	   0,    0,    0,  165, 1384,    0,  764,    0,    0,    0,
+	   0,  397, 1868,  422,    0,    0,    0, 1244, 1567,    0,
+	   0,    0, 1468,    0,    0,    0, 1614,    0,  411,    0,
+	   0, 1775,    0, 2078,    0, 1006,    0,  715,  406,    0,
+	1238,  658, 1299,    0,  610,  208,  886,    0,  241, 1019,
+	  64,    0,    0,   50, 1579,    0, 1953,    0,    0,    0,
+	   0,    0,  190,    0,    0,    0,    0,  107,    0, 1108,
+	1401,  889,  497,    0,    0,  262,    0,   13,  513, 2033,
+	 918,    0, 1326,    0,  143,   23,  955, 1350,  379, 1449,
+	1971,  691, 1892, 1978,  584,    0,    0, 1752,    0, 1732,
+	   0,    0,    0, 1781,  751,    0,    0,    0,    0,    0,
+	   0, 1551,    0,    0, 1910,    0, 1434,    0, 1484,    0,
+	   0, 2014,  238,  240, 1914, 1455,   70,  804, 1357, 1496,
+	1695,    0,  672,    0, 1398,    0, 2034,    0, 1838,    0,
+	 628,    0,    0,  137, 1741,    0, 1086,    0,    0, 1625,
+	 823,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+	   0,    0,  739, 1034, 1936,  419, 1107,    0,    0,    0,
+	1160,    0,  548, 1341,    0,    0,  468, 1918,    0,    0,
+	1629, 1457,    0,    0, 1667,  779,    0,  121, 1792,    0,
+	1743,    0, 1501,  263,  857, 1216,    0,    0, 2124, 1408,
+	2103,    0,  151,    0,    0,    0, 1283,    0, 1241,  461,
+	   0,  564,  840,  771,    0, 1182,    0,    0,    0,    0,
+	 881,    0,  741,  327,  354, 1855,    0, 1442,  542,    0,
+	  32,  309,    0, 1680, 1438,  722, 2079,    0,  455,    0,
+	1383,    0, 1754,    0,  258, 1104,    0,    0,    0,    0,
+	 275, 1815,    0,    0,    0, 1377,  760,    0, 1021,  833,
+	1749, 1431, 1789,   51,    0,    0, 1277,    0,  834,    0,
+	   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+	   0,    0, 1420,  582,  173,    0, 1079,  429, 1856,    0,
+	   0, 1707,    0,  692,  820,    0,    0,    0,    0,  449,
+	   0,    0,    0, 1764,    0, 1128,    0,    0,  915,    0,
+	 256,    0,    0,  260,    0, 1001,   10, 1756,    0, 1439,
+	1386, 1805,    0,  346,    0,  785,    0,    0, 1594, 1211,
+	1010,    0,    0, 1915,  898,    0,    0,  314,  350,   89,
+	 822,  681,  142,  359,  130,    0, 1127,    0,    0, 2095,
+	   0, 1901,    0, 1745,    0, 1830,    0,    0,  867,  409,
+	1927,    0,  285, 1637, 1249, 1415,  534, 2019,    0,    0,
+	 887,    0, 1133,    0, 1057, 1510,    0,    0,    0, 1317,
+	   0, 1085,  872,  678, 1124,    0,    0,    0,  495,  984,
+	   0,    0, 1739, 1271,    0,    0,  405,    0,    0, 1240,
+	 328, 1399, 1757,    0, 1787, 1670,    0,    0,  982,  657,
+	1948, 1233,    0,    0,    0,  787, 1259,    0,  578, 1282,
+	   0, 1454,    0,  347,    0, 2064,   88,    0,    0, 1258,
+	   0,  962,    0,    0, 1039,  667,    0,    0,    0,  499,
+	   0,  412, 1719,    0,    0,  134,  646, 1144, 2054,    0,
+	 725, 1295,    0,  489,    0, 1161,    0,  169, 1720,    0,
+	1125, 1996, 1818,    0,  152,  255,  494, 1718, 1888, 1096,
+	   0,  230, 1413,    0, 1523,    0,  693, 1297,  203, 1727,
+	   0,    0,    0,    0, 1897,    0,    0,    0,    0,  183,
+	1053, 1087,    0,  635, 1982,    0,  307, 1078, 1428,  113,
+	 967,  311,  483, 1788,    0,  746,    0, 1500,    0,    0,
+	   0,    0,    0,    0,    0,  911,  843,  696, 1565,    0,
+	   7,    0,    0,    0,  810,    0, 2089,    0,  124, 1768,
+	 856, 1193,    0,    0, 2082,    0,    0,    0,  106, 1889,
+	   0,    0,  317,    0,    0, 1489, 1698,    0,    0, 1106,
+	 650, 1059, 1587,    0,    0,    0,  723,    0,    0,    0,
+	   0, 1893,    0, 1220,  846,    0,    0,    0,    0,    0,
+	   0,  522, 2123,    0, 1152, 1256,  447,  842,  366,  503,
+	1767,    0,    0, 1224,    0,  790, 1802, 1793,    0,  838,
+	1660, 1704,    0,    0, 1903,    0, 1329,    0, 1803,    0,
+	 388,  174, 2005,  512, 1178, 1716,    0,  249, 1168, 2059,
+	  95,    0,  755,    0,    0,    0,    0, 1460,    0,    0,
+	 916,    0, 1933, 1796,    0,    0, 1338,    0, 1908,  400,
+	1497,  358,    0,    0,    0,  186, 1200,    0,    0,    0,
+	   0,  287, 1374,    0, 2068,    0, 1323, 1201,    0,    0,
+	   0,    0,   48, 1887,    0,    0,  685,  778,  529,    0,
+	1673,    0,    0,    0, 1761, 1734,  493,    0,    0, 1159,
+	   0,    0,    0,    0,   40,    0,    0,    0,  877,    0,
+	   0,  353,    0,  875,    0,  890,  250,  296,    0,    0,
+	   0,  652,    0,   21, 1885,    0,  773,    0,  160,    0,
+	   0,  180, 1435,    0, 1676,    0,  115, 1071,  418,    0,
+	   0,  135,    0,    0,    0,  336,  572, 2111,    0, 2081,
+	   0,    0, 1032,    0, 1113,    0,    0, 1011,  674, 1080,
+	   0, 1427,    9,    0,    0,    0,    0, 1807,   37, 1798,
+	1569, 2044, 1307,  863,    0, 1511, 1149,    0,  500,    0,
+	   0,    0,    0,    0,    0,    0,    0, 1360, 1461, 1217,
+	1769,    0, 1553,    0,    0,  431,  772, 1335,    0, 1881,
+	  16, 1822,  828, 1974,    0,  993, 1956, 2084, 1033,    0,
+	1239,    0,    0, 1324,  261,    0,    0,  806, 1395, 1668,
+	   0,  686,    0,    0,    0,   55,  924, 2122, 1989,   43,
+	   0,  706,    0,    0,    0,  371,  284,    0,    0,    0,
+	 325, 1169, 1176,    0,    0,    6, 1466,  471,  442,  243,
+	1912,    0, 1065,    0, 1987, 1737, 2112, 2002,    0,    0,
+	   0,    0,    0,    0,    0, 1056, 1691,    0,  531,  668,
+	   0, 1493, 1837, 1877,    0, 2109,  847,    0,    0, 1926,
+	   0,    0,    0,    0,    0,    0, 1237, 1055,  337, 2003,
+	   0,    0,  784,    0, 1708, 1418, 1616,    0,    0,    0,
+	 637,    0, 1421, 1044,  185,  932, 1417,    0,    0,  270,
+	   0,  824,  580,    0, 1909, 1605,  291,  122, 1527,    0,
+	1242, 2088,    0,    0,    0,    0,    0,    0, 1150,    0,
+	   0,    0,  553,    0,    0, 1726, 1202,    0,  392, 1684,
+	 585, 1316,    0,    0, 1753,    0,    0,    0,  179,    0,
+	1180,    0,    0,    0,    0, 1528, 2017,   56,    0,    0,
+	1379,    0,    0,    0,    0, 1115, 2016,    0,  232,    0,
+	1129, 1808,    0, 1804, 1007,  129,  871,    0, 1991,    0,
+	1005,    0,    0,  893, 2115, 1453,    0,    0, 1988, 1479,
+	   0,  394, 2083,    0,    0,  844,    0,  728,    0, 1806,
+	1839,    0,    0,    0, 1835,  402,  971,  910, 1819,    0,
+	1469,    0, 1849,  891,    0,    0,    0,    0,  569,  220,
+	2036,    0,  604, 1539,  839,    0,  444,    0,    0,    0,
+	  84,    0, 1902, 1862, 1864,  101,    0,    0,  370, 1218,
+	1046,    0,  393,   68,    0,    0,    0,    0,    0,    0,
+	1809,  303,    0,    0,    0,    0,    0,    0, 1521,  416,
+	2049,    0,    0,    0,  708,    0,    0,    0,  515,    0,
+	 510,    0,    0,  632,    0,    0,    0,    0, 1590,    0,
+	1141, 1522,    0,    0,    0, 1351,    0,   28,    0,  633,
+	1964, 1820, 1382,    0,  841,  775,    0,    0,    0,    0,
+	   0,  464,  139,   42, 1592,  994, 1748,  248,    0,    0,
+	1089, 1025,  601, 1172, 1333, 2098,    0,    0,    0,  914,
+	 482,  433, 1412,    0,  776, 1367,    0, 2094,  655,    0,
+	   0,    0,    0,  654, 1524,    0,    0,    0,   80, 1529,
+	   0,    0,  713,  384, 1166,  149, 1336,  829,    0, 1409,
+	 408,  527,    0,    0,    0,    0,    0, 1710, 1992,    0,
+	   0,  473, 1935,    0, 1559, 1100,  200,  312, 1045,  164,
+	   0, 1674,    0,    0,    0, 1040,    0,  636,    0, 1391,
+	2058, 1411,    0,    0,    0, 1970,  750,    0, 1657, 2032,
+	   0,    0,  504,  187, 1429, 1267,  912, 1470,  298,  480,
+	1851,    0, 1423,   29,    0,    0,  874,    0, 2018,  988,
+	   0,    0,    0,  466,  638,    0,    0, 1622,    0,    0,
+	   0,    0,    0,    0,  210,    0,  390,  225,  825,  836,
+	 507,    0,  383, 1179, 1477,    0, 1898, 1281, 1994,    0,
+	1030,    0,    0, 1018,    0,  897,    0,    0,    0,    0,
+	 128,    0,    0,  814,  695, 1562,  765,  244,  998,   27,
+	   0,    0,    0,    0,    0,    0,    0, 1456,    0,  516,
+	 502,  539,  903, 1047,    0,  140, 1482, 1943,    0, 1154,
+	   0,    0,   85,    0,    0,    0,  782,    0,  293,  399,
+	1263,    0, 1683,    0,    0,    0,    0,  161,    0,    0,
+	1679,  894,    0,    0,    0, 1530,    0,    0, 1545,    0,
+	 451,    0,    0,    0, 1644,  648,    0,    0,    0,    0,
+	   0,    0,    0,    0,  369,  363, 1709,    0,    0,    0,
+	1632,  486,    0,  484,    0, 2073,  432,    0,    0, 1696,
+	   0, 1286,    0,    0,    0, 1949, 1262,    0, 1526, 1194,
+	 544,    0,   75,    0,  436,    0,    0, 1836, 1052, 1854,
+	   0,    0,    0,    0, 1688,  505, 2013,  446,    0,  902,
+	 228,  144,  613, 2062,    0,  974,  597, 1907, 1634,  860,
+	   0,  175, 1347, 1170, 1077,  348,    0,    0,    0,    0,
+	1310,    0,    0,    0,    0,    0,  478,    0, 1942, 1571,
+	   0, 1419,    0, 1543,    0,  391,    0,    0,    0, 1051,
+	   0,    0,    0,  960,    0,    0,    0,    0,    0,   96,
+	  26, 1189,  968,    0,  896,  218,    0, 1799,    0,  730,
+	 724,    0,    0, 1119,    0,    0,    0,    0,    0, 1517,
+	  62,    0,    0,    0,   36,    0, 1474, 1858, 1968, 2035,
+	 959,  869,  252, 1330,  737,   83,    0,    0,  209,    0,
+	 556,    0,    0,    0,    0, 1422, 1392, 1584,    0,    0,
+	   0,    0,    0,  761,    0, 1566,    0,    0,  987,    0,
+	   0,    0,  310, 1311, 1092,   61, 1342,    0,    0,    0,
+	 470,  519,  485, 1452,  740,    0,    0,    0, 1145,    0,
+	   0, 1847,    0, 1036,    0,    0,    0,    0,  575,  865,
+	   0,    0,  621,    0,  352,  733, 1533,  712, 2028, 1017,
+	   0,    0,    0,    0,  921,    0,    0,  158,  862, 1610,
+	 602,    0,    0, 1290,    0,    0,    0,  927,   60, 1214,
+	  99,   86,  428, 1586,  991,   14, 1264,    0,    0,    0,
+	 759,    0,   46, 1134,  969, 1827, 1873,    0, 1000, 1062,
+	   0,  104,    0,  288, 1035,  364,  247,    0,    0,    0,
+	 852,    0,    0,    0, 1253, 1291,    0, 1722,    0,    0,
+	   0,    0,  700, 1623,    0,    0,    0,    0,    0, 2080,
+	   0,    0,  718, 1556,    0, 1158, 1480, 1126,    0,    0,
+	   0,    0,    0,    0, 2015,    0, 2117,    0,    0,    0,
+	   0,  736,    0, 1966, 2120,    0,    0,    0,    0,    0,
+	1094,  797, 1596,    0, 1601, 1834, 1617,    0, 1663,    0,
+	2070,    0,  586, 2101, 1608,    0,    0, 1370,    0,  465,
+	   0, 1488,  345, 1826,    0,    0,    0,    0,    0,    0,
+	   0,    0,    0,  239,    0,    0,    0, 1084, 2053,   20,
+	   0,    0,    0,    0,    0, 1947, 1816,    0,    0, 1661,
+	 111,    0, 2031, 1490,  103, 1378,  267,    0,  278, 1550,
+	1575, 2085, 1701,    0,    0,    0,    0, 1508,    0,  251,
+	   0,  926, 2071,    0,    0, 1735,    0,    0, 1184, 1959,
+	   0, 1162,  948,    0,    0,    0,  961,    0,    0,    0,
+	   0, 2046,    0,    0,    0,    0,    0,    0,    0,  605,
+	1068,  615, 1458,    0, 1325,  159,    0,  245,    0, 1327,
+	   0,    0,    0, 1506,  541,    0,    0,   78,   53,  441,
+	1123,  467,    5,    0,    0, 2042, 1343,  594, 1755,  647,
+	   0, 1979, 2027,    0,  727,    0,    0,    0,    0, 1564,
+	   0,    0, 1946, 1534, 2025, 1845, 1503,    0,    0,    0,
+	   0, 1029,    0,    0,   45,    0, 1662, 2106,    0, 1648,
+	 469,    0,    0,    0,    0,  297,    0,  533,  323,  958,
+	1772,   91,    0, 1205,    0,    0,    0,    0,    0,    0,
+	   0,  726,  280,    0, 1563,    0,    0, 1225,    0,    0,
+	1609,    0,    0, 1339,  155, 1513,  796, 1151,    0,    0,
+	   0, 1328,  596,    0, 2020,    0,    0,    0, 1276,  608,
+	   0,    0, 1462,  587,    0,  264,    0,  445,    0, 1880,
+	1050,  313,  634,  769,  458, 1475,    0, 1167,  855, 1931,
+	1112,    0, 1965,    0,  182, 1985,  763,    0,  983, 1037,
+	   0, 1287,    0,  664,  368,    0, 1446,  492, 1196,    0,
+	   0,    0, 1213,  738, 1509,    0,    0, 1699,    0, 1595,
+	   0, 1315,  558,    0,  581, 1598,  937, 1109,  689,  196,
+	1376, 1906,    0, 1116, 1686,    0,    0, 1406,    0,  977,
+	 514,    0, 1817, 2066,  168, 1894, 1426,    0,    0,    0,
+	   0,    0, 1560,  242,    0, 1905, 1653,  282, 1773, 1322,
+	   0,    0,    0,    0,    0,    0,    0, 1886, 1540, 2043,
+	 957,    0,  276,    0, 2038, 1621,  549,    0,  351,    0,
+	1960,    0,    0,  592,    0,  563,    0,  417,  289,    0,
+	 235,  734,  749,    0,    0, 2022,    0, 1636,  985,  490,
+	   0,    0,   52,    0,    0,    0, 1552,    0, 1230,    0,
+	   0,    0,    0,   94,  614,    0,  774,  508,    0,  102,
+	   0,  326,  570, 1067,  830,  640,    0,  732,  475,    0,
+	1206, 1504,    0, 1846,    0, 1069,    0,  928,   11,  882,
+	   0, 1654, 1234,    0,    0,    0,    0,    0,    0,    0,
+	 195,    0, 1763,    0, 2023,  457,    0,  920,    0,    0,
+	   0,  611,    0,  878,    0,  381,    0, 1138,    0,    0,
+	1165, 1652,  498,    0,    0,    0,    0,    0,  816,    0,
+	1304,    0,    0,  826,  574,    0,  922,    0, 1857,  716,
+	 100,    0,    0, 1742,  150,    0, 1646,    0,   17,  132,
+	   0,  851, 1759,  802,  385,    0, 2069,  677,  990,    0,
+	1026,    0, 1606,    0,   97,    0, 1570, 1514,    0,    0,
+	   0,    0,    0,    0,    0,    0,    0,  378, 1665,    0,
+	   0,    0,  864, 1321,    0,  342, 1733,  979,    0, 2118,
+	   0,  904, 1349,    0, 2040, 1507, 1048,    0,    0, 1736,
+	1219, 1681, 1765,    0,  440,    0, 1981, 1977,  273, 1546,
+	   0,    0,    0, 1187,    0,    0,  532,  415, 1111,    0,
+	 617,    0,    0, 1476,    0, 1703, 2050,  110,    0,    0,
+	 460,    0,    0, 1945,  831,    0,    0, 1850,  334, 1088,
+	1394,  167,    0,  662,    0, 1639,    0,   72, 2116,    0,
+	2092,  221,   57,  606,    0,    0,    0,  404,  729,    0,
+	1628,    0,  321,    0, 1171,    0,  704,    0,    0,    0,
+	 892,  266,    0,    0,    0,    0,  792,    0,    0,    0,
+	   0,  815,  236,  978,  535, 1147,    0,  866,    0,    0,
+	   0, 2047, 1348,  477,    0, 1631,  302,  145,    0,  699,
+	   0, 1156, 1976,    0,    0,    0,  952,  147,   31, 1284,
+	   0,    0,    0, 1896, 1780,  375,    0,    0,    0,    0,
+	   0,  721,    0,    0,  191,    0, 1712, 1519,    0,    0,
+	 511, 2024,  528,    0,    0,    0,  109,    0, 1589,    0,
+	 941, 1642,    0,    0, 1633,  735,  448,    0,  536, 1697,
+	1022, 1188,   65,    0,  783,  213,    0,    0,    0, 1541,
+	1515,  222,    0,    0, 1199, 1548,    0,    0, 1872, 1675,
+	   0, 1618, 1505, 1611,  963,    0,  571, 1593, 1554,    0,
+	   0,  114,  320,    0, 1314, 1272, 1373,  434,    0,    0,
+	   0,    0,  837,    0,    0, 1999,    0,    0,    0,  306,
+	   0,    0,    0,    0,    0,  996,  547,    0,    0,   24,
+	   0, 1900,  372,    0, 1604,    0,    0,    0, 1689,    0,
+	1163, 1487,    0,    0, 1334, 1140,    0, 1547,   93, 2045,
+	1785,    0,    0, 1512, 1795, 1229,  562,    0, 1823,  946,
+	   0,    0,    0,    0,  748,    0,    0,    0,    0,  682,
+	   0,    0,    0, 1288,  305,    0,  707, 1602,  322, 1083,
+	   0,  999,    0,  551,    0, 1031,    0, 1340,    0,    0,
+	1093,    0,    0,    0, 1702,    8, 1404, 1313,  936,  986,
+	   0,    0, 1247,    0,  913,    0,    0,    0, 1911,    0,
+	   0, 1231, 1578,  794,  644,    0, 1940,    0,    0, 1572,
+	   0,    0,    0,  835,    0,  939,  717,  731, 1774,    0,
+	  74,    0,  452,    0,    0,  163,    0,    0,  545,    0,
+	   0,  335, 1656,  283, 2004,    0, 1717,    0, 1139, 2026,
+	 870,    0,    0,    0, 1917,    0,  398, 1954,  189,    0,
+	1746, 1209, 1955,  184,  423,  154,  300, 1494,    1, 1824,
+	1266,    0,  705,  567, 2060,    0,    0,  119, 1280,    0,
+	   0,  670, 1450,    0,    0, 1043,   47,    0, 1724,    0,
+	   0,    0,    0, 2001, 1928, 1782,  229, 1486,    0, 1922,
+	   0,   35, 1776, 1778, 2009,  697, 1921,  550,    0,    0,
+	1875,  627,    0,    0,    0,    0,  426, 1983, 1573,    0,
+	1740,    0,    0, 1293,  992, 1195, 1365,    0,    0, 2056,
+	 680, 1261,    0,    0,    0, 1626,   41,    0,    0,   34,
+	1786,  588,  157,    0, 1355,    0,    0,    0, 1498,  883,
+	 805,  684,  338,    0,  884, 1925,    0,    0,    0,    0,
+	   0,    0,    0, 1345,    0, 1465,    0,    0, 2087, 2086,
+	 795, 1243,  105,  265, 1813,   63, 1649, 1388,    0,  566,
+	   0,    2,    0,  679,    0,    0,  488,    0, 1192,    0,
+	1790,    0,    0, 1076,    0,  850,  430,  226,    0, 1136,
+	   0,    0,    0,  885,    0, 1961,    0, 2029, 1148, 1866,
+	   0,    0, 1289,  481,  622,  108,    0,    0, 1433,  744,
+	 474,    0, 2065,    0,    0,  216,    0,    0, 1840,  214,
+	 848,    0,    0,    0, 1542, 1624,    0,    0,  800,    0,
+	   0,    0,    0,  661,    0,    0, 1557,    0, 1430,    0,
+	1298,  660,  976,    0,  561,    0, 1693,  237,    0,    0,
+	1396,    0,  437,    0, 1008,    0, 1185,    0,    0,  980,
+	2067,    0,  868, 1198,    0, 1980,    0, 1958, 1436, 1275,
+	 701,  907,    0,  945,    0,    0,  227,    0, 2075,  888,
+	   0,  676,    0,  382,    0,    0,    0,  472,   15,    0,
+	 618,    0, 1135,    0, 1361,    0,    0,    0,  719, 2099,
+	   0,  900,    0,    0, 1102,    0,    0,    0,    0,    0,
+	   0,    0, 2041,  380, 1937,    0,    0, 1729,  204,  223,
+	 365,  269, 2048, 1363,    0,    0,    4,    0,    0,  673,
+	1666, 1483,    0,    0,  645,    0,    0,    0,  162,    0,
+	   0,    0, 1801,    0,  752, 1791,    0,  295,    0, 1252,
+	1197, 1081,    0,    0,  133,  940, 2006,    0,    0,    0,
+	 294, 1223, 1869,  879,  683,    0, 1651,  951,    0, 1659,
+	   0,  803,  766, 1583,    0,    0,    0,    0,    0,    0,
+	1730,    0, 1432,    0,    0, 1236,  361,  711, 1445,    0,
+	2007,    0, 1248,    0,    0,  112, 1227,    0, 1895,  315,
+	   0, 1221,    0,  420,    0, 1204,    0, 1058,    0,    0,
+	 616, 1871,    0,    0,  583,  777,    0, 1929, 1672,    0,
+	 666, 1957,    0,   82,    0,    0, 1016,    0,  612,  178,
+	1950,   54,    0,    0,    0, 2096,    0,    0,  786, 1848,
+	1364,    0,    0,   66,   69,  389,   59,  125,  641,    0,
+	1358,    0, 1013, 1393,    0, 1390,    0, 1063,    0,    0,
+	   0, 1641,  720,    0, 1372, 1186, 1173, 1650, 1502,    0,
+	   0, 1060,    0,  703,  639, 1993, 1814, 2100, 1269,    0,
+	1403, 1619,    0, 1375,  268,    0,  376,    0,  651,    0,
+	   0,  453, 1402, 1164,    0,    0,  923,    0,    0,    0,
+	   0, 1303,  211,  318,    0,  202,    0,  292, 1369, 1544,
+	  30,    0,    0,  172,    0,    0,   73,    0,  845, 2077,
+	   0, 1270,    0,    0,    0, 1899,  118,    0, 1130,  573,
+	   0, 1690,  600, 1669, 1143,    0, 1020,    0,    0, 1711,
+	   0,    0,  623,  463,    0,    0,    0, 1368,  854, 1302,
+	1832,    0,  663,    0,  116,  424,    0,    0, 1064,    0,
+	1049,    0,    0, 1371, 2021,    0, 1655,    0, 1612,    0,
+	1630,    0,    0,    0,    0, 1157, 1405,    0,    0,    0,
+	1292,    0, 1990,  188,    0,    0,    0, 1183,    0,    0,
+	 304,    0, 1362,    0,  332,  821,    0,  649,    0,  207,
+	   0,    0,  286,    0,  374, 1725,    0,    0,    0,    0,
+	1861,  899,    0,    0,  709,    0, 1235,    0, 1731, 1354,
+	1664,    0,    0, 2039,    0, 1810,    0, 1919,    0,  117,
+	   0,  593,  956,    0, 1495, 1692, 1842,  219, 1585,    0,
+	   0,  919, 1969,  965, 1425,  789,    0,    0,    0,    0,
+	   0,    0, 1577,    0,  832,    0
+};
+
+static	const struct nametab entitytab = {
+	entitydisp, entityslot, 11, 12
+};
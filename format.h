@@ -19,5 +19,7 @@
  * The interface of the mdoc(7) formatter.
  */
 
-void	 ptree_print_mdoc(struct ptree *);
-void	 ptree_print_tree(struct ptree *);
+struct sink;
+
+void	 ptree_print_mdoc(struct ptree *, struct sink *);
+void	 ptree_print_tree(struct ptree *, struct sink *);
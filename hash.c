@@ -0,0 +1,183 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hash.h"
+
+/*
+ * The implementation of the SHA-256 message digest, FIPS 180-4,
+ * used for identifying cached conversion results by their input.
+ */
+
+#define	ROR(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+
+static	const uint32_t k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+
+static void
+hash_block(struct hash *h, const unsigned char *b)
+{
+	uint32_t	 w[64], s[8], t1, t2;
+	int		 i;
+
+	for (i = 0; i < 16; i++)
+		w[i] = (uint32_t)b[4 * i] << 24 |
+		    (uint32_t)b[4 * i + 1] << 16 |
+		    (uint32_t)b[4 * i + 2] << 8 | b[4 * i + 3];
+	for (; i < 64; i++)
+		w[i] = w[i - 16] + w[i - 7] +
+		    (ROR(w[i - 15], 7) ^ ROR(w[i - 15], 18) ^
+		     (w[i - 15] >> 3)) +
+		    (ROR(w[i - 2], 17) ^ ROR(w[i - 2], 19) ^
+		     (w[i - 2] >> 10));
+	memcpy(s, h->state, sizeof(s));
+	for (i = 0; i < 64; i++) {
+		t1 = s[7] + (ROR(s[4], 6) ^ ROR(s[4], 11) ^ ROR(s[4], 25)) +
+		    ((s[4] & s[5]) ^ (~s[4] & s[6])) + k[i] + w[i];
+		t2 = (ROR(s[0], 2) ^ ROR(s[0], 13) ^ ROR(s[0], 22)) +
+		    ((s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]));
+		memmove(s + 1, s, 7 * sizeof(*s));
+		s[4] += t1;
+		s[0] = t1 + t2;
+	}
+	for (i = 0; i < 8; i++)
+		h->state[i] += s[i];
+}
+
+void
+hash_init(struct hash *h)
+{
+	static const uint32_t init[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+		0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+
+	memcpy(h->state, init, sizeof(h->state));
+	h->len = 0;
+}
+
+void
+hash_update(struct hash *h, const void *data, size_t sz)
+{
+	const unsigned char	*cp;
+	size_t			 have, need;
+
+	cp = data;
+	have = h->len % 64;
+	h->len += sz;
+	if (have > 0) {
+		need = 64 - have;
+		if (sz < need) {
+			memcpy(h->buf + have, cp, sz);
+			return;
+		}
+		memcpy(h->buf + have, cp, need);
+		hash_block(h, h->buf);
+		cp += need;
+		sz -= need;
+	}
+	for (; sz >= 64; cp += 64, sz -= 64)
+		hash_block(h, cp);
+	memcpy(h->buf, cp, sz);
+}
+
+/*
+ * Finish the digest and store it as a NUL-terminated
+ * hexadecimal string in hex[HASH_HEXSZ].
+ */
+void
+hash_final(struct hash *h, char *hex)
+{
+	unsigned char	 pad[72];
+	uint64_t	 bits;
+	size_t		 padsz;
+	int		 i;
+
+	bits = h->len * 8;
+	padsz = 64 - (h->len + 8) % 64;
+	memset(pad, 0, sizeof(pad));
+	pad[0] = 0x80;
+	for (i = 0; i < 8; i++)
+		pad[padsz + i] = bits >> (56 - 8 * i);
+	hash_update(h, pad, padsz + 8);
+	for (i = 0; i < 8; i++)
+		snprintf(hex + 8 * i, 9, "%08x", h->state[i]);
+}
+
+/*
+ * Compute the hex digest of the remaining contents of the file fd.
+ * Return 0 on success or -1 if the file cannot be read.
+ */
+int
+hash_fd(int fd, char *hex)
+{
+	struct hash	 h;
+	char		 b[8192];
+	ssize_t		 rsz;
+
+	hash_init(&h);
+	while ((rsz = read(fd, b, sizeof(b))) != 0) {
+		if (rsz == -1) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		hash_update(&h, b, rsz);
+	}
+	hash_final(&h, hex);
+	return 0;
+}
+
+/*
+ * Compute the hex digest of the contents of the file fname.
+ * Return 0 on success or -1 if the file cannot be read.
+ */
+int
+hash_file(const char *fname, char *hex)
+{
+	int		 fd, rc;
+
+	if ((fd = open(fname, O_RDONLY, 0)) == -1)
+		return -1;
+	rc = hash_fd(fd, hex);
+	close(fd);
+	return rc;
+}
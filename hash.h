@@ -0,0 +1,35 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * The interface of the SHA-256 message digest.
+ */
+
+#define	HASH_SZ		32	/* Size of a digest in bytes. */
+#define	HASH_HEXSZ	65	/* Size of a hex digest with NUL byte. */
+
+struct	hash {
+	uint32_t	 state[8];
+	uint64_t	 len;      /* Number of bytes processed. */
+	unsigned char	 buf[64];  /* Pending partial block. */
+};
+
+void	 hash_init(struct hash *);
+void	 hash_update(struct hash *, const void *, size_t);
+void	 hash_final(struct hash *, char *);
+int	 hash_fd(int, char *);
+int	 hash_file(const char *, char *);
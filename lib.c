@@ -0,0 +1,235 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "xmalloc.h"
+#include "node.h"
+#include "parse.h"
+#include "reorg.h"
+#include "sink.h"
+#include "format.h"
+#include "docbook2mdoc.h"
+
+/*
+ * The implementation of the public library interface,
+ * wrapping the parser, the tree reorganizer, and the formatters.
+ */
+
+struct	d2m_doc {
+	struct parse	*parser;
+	struct ptree	*tree;   /* Parse result, owned by the parser. */
+	struct d2m_cache *cache; /* Cache used for parsing or NULL. */
+	struct arena	*arena;  /* Tree storage from the cache or NULL. */
+	struct d2m_msg	*msgs;   /* Messages collected while parsing. */
+	size_t		 msgsz;  /* Number of messages. */
+	size_t		 msgmax; /* Allocated size of msgs. */
+	int		 flags;
+#define	DFLAG_REORG	 (1 << 0)  /* The tree was reorganized. */
+#define	DFLAG_RENDER	 (1 << 1)  /* The tree was consumed by rendering. */
+};
+
+/*
+ * Besides included files, a cache keeps the storage of the last
+ * parse tree freed, such that the next document parsed with it
+ * does not have to allocate all its memory again.
+ */
+struct	d2m_cache {
+	struct pcache	*pcache; /* Parse trees of included files. */
+	struct arena	*arena;  /* Storage for the next tree or NULL. */
+};
+
+
+static void
+d2m_addmsg(void *arg, const char *fname, int line, int col,
+    int level, const char *text)
+{
+	struct d2m_doc	*doc;
+	struct d2m_msg	*msg;
+
+	doc = arg;
+	if (doc->msgsz == doc->msgmax) {
+		doc->msgmax = doc->msgmax ? doc->msgmax * 2 : 8;
+		doc->msgs = xreallocarray(doc->msgs,
+		    doc->msgmax, sizeof(*doc->msgs));
+	}
+	msg = doc->msgs + doc->msgsz++;
+	msg->fname = xstrdup(fname);
+	msg->text = xstrdup(text);
+	msg->line = line;
+	msg->col = col;
+	msg->level = level;
+}
+
+struct d2m_cache *
+d2m_cache_alloc(void)
+{
+	struct d2m_cache	*c;
+
+	c = xcalloc(1, sizeof(*c));
+	c->pcache = pcache_alloc(NULL);
+	return c;
+}
+
+void
+d2m_cache_free(struct d2m_cache *c)
+{
+	if (c == NULL)
+		return;
+	pcache_free(c->pcache);
+	arena_free(c->arena);
+	free(c);
+}
+
+static struct d2m_doc *
+d2m_alloc(struct d2m_cache *c, int flags)
+{
+	struct d2m_doc	*doc;
+
+	doc = xcalloc(1, sizeof(*doc));
+	doc->parser = parse_alloc(flags & D2M_WARN);
+	parse_setmsg(doc->parser, d2m_addmsg, doc);
+	if (c != NULL) {
+		parse_setcache(doc->parser, c->pcache);
+		if ((doc->arena = c->arena) == NULL)
+			doc->arena = arena_alloc();
+		c->arena = NULL;
+		parse_setarena(doc->parser, doc->arena);
+		doc->cache = c;
+	}
+	return doc;
+}
+
+/*
+ * Parse a complete document of sz bytes from buf.
+ * The name fname is used in messages and as the base
+ * for relative names of included files; it may be NULL.
+ * The cache c may be NULL.
+ */
+struct d2m_doc *
+d2m_parse(struct d2m_cache *c, const char *buf, size_t sz,
+    const char *fname, int flags)
+{
+	struct d2m_doc	*doc;
+
+	doc = d2m_alloc(c, flags);
+	doc->tree = parse_buf(doc->parser, buf, sz,
+	    fname == NULL ? "<buffer>" : fname);
+	return doc;
+}
+
+/*
+ * Open and parse the file fname.
+ */
+struct d2m_doc *
+d2m_parse_file(struct d2m_cache *c, const char *fname, int flags)
+{
+	struct d2m_doc	*doc;
+
+	doc = d2m_alloc(c, flags);
+	doc->tree = parse_file(doc->parser, -1, fname);
+	return doc;
+}
+
+/*
+ * Reorganize the parse tree for formatting; sec overrides
+ * the manual section given in the document unless it is NULL.
+ * This is called automatically by d2m_render() if needed.
+ */
+void
+d2m_reorg(struct d2m_doc *doc, const char *sec)
+{
+	if (doc->flags & DFLAG_REORG)
+		return;
+	ptree_reorg(doc->tree, sec);
+	doc->flags |= DFLAG_REORG;
+}
+
+/*
+ * Format the document into a NUL-terminated buffer that the caller
+ * has to free(3), store its length in *sz unless sz is NULL.
+ * Formatting consumes the tree, so this can only be done once;
+ * later calls return NULL.
+ */
+char *
+d2m_render(struct d2m_doc *doc, enum d2m_outt outt, size_t *sz)
+{
+	struct sink	 out;
+
+	if (doc->flags & DFLAG_RENDER)
+		return NULL;
+	d2m_reorg(doc, NULL);
+	doc->flags |= DFLAG_RENDER;
+	sink_init_buf(&out);
+	if (doc->tree->root != NULL) {
+		if (outt == D2M_MDOC)
+			ptree_print_mdoc(doc->tree, &out);
+		else
+			ptree_print_tree(doc->tree, &out);
+	}
+	sink_putc(&out, '\0');
+	if (sz != NULL)
+		*sz = out.len - 1;
+	return out.b;
+}
+
+/*
+ * Return the messages collected while parsing
+ * and store their number in *sz.
+ */
+const struct d2m_msg *
+d2m_msgs(const struct d2m_doc *doc, size_t *sz)
+{
+	*sz = doc->msgsz;
+	return doc->msgs;
+}
+
+/*
+ * Return the exit status docbook2mdoc(1) would use for this document:
+ * 0 for success, D2M_WARNING, or D2M_ERROR.
+ */
+int
+d2m_status(const struct d2m_doc *doc)
+{
+	return doc->tree->flags & TREE_ERROR ? D2M_ERROR :
+	    doc->tree->flags & TREE_WARN ? D2M_WARNING : 0;
+}
+
+void
+d2m_free(struct d2m_doc *doc)
+{
+	size_t		 i;
+
+	if (doc == NULL)
+		return;
+	for (i = 0; i < doc->msgsz; i++) {
+		free(doc->msgs[i].fname);
+		free(doc->msgs[i].text);
+	}
+	free(doc->msgs);
+	parse_free(doc->parser);
+	if (doc->arena != NULL) {
+		if (doc->cache->arena == NULL) {
+			arena_reset(doc->arena);
+			doc->cache->arena = doc->arena;
+		} else
+			arena_free(doc->arena);
+	}
+	free(doc);
+}
@@ -16,10 +16,10 @@
  */
 #include <assert.h>
 #include <ctype.h>
-#include <stdio.h>
 #include <string.h>
 
 #include "node.h"
+#include "sink.h"
 #include "macro.h"
 
 /*
@@ -33,10 +33,10 @@ para_check(struct format *f)
 	if (f->parastate != PARA_WANT)
 		return;
 	if (f->linestate != LINE_NEW) {
-		putchar('\n');
+		sink_putc(f->out, '\n');
 		f->linestate = LINE_NEW;
 	}
-	puts(".Pp");
+	sink_puts(f->out, ".Pp\n");
 	f->parastate = PARA_HAVE;
 }
 
@@ -47,26 +47,26 @@ macro_open(struct format *f, const char *name)
 	switch (f->linestate) {
 	case LINE_MACRO:
 		if (f->flags & FMT_NOSPC) {
-			fputs(" Ns ", stdout);
+			sink_puts(f->out, " Ns ");
 			break;
 		}
 		if (f->nofill || f->flags & (FMT_CHILD | FMT_IMPL)) {
-			putchar(' ');
+			sink_putc(f->out, ' ');
 			break;
 		}
 		/* FALLTHROUGH */
 	case LINE_TEXT:
 		if (f->nofill && f->linestate == LINE_TEXT)
-			fputs(" \\c", stdout);
-		putchar('\n');
+			sink_puts(f->out, " \\c");
+		sink_putc(f->out, '\n');
 		/* FALLTHROUGH */
 	case LINE_NEW:
-		putchar('.');
+		sink_putc(f->out, '.');
 		f->linestate = LINE_MACRO;
 		f->flags = 0;
 		break;
 	}
-	fputs(name, stdout);
+	sink_puts(f->out, name);
 	f->flags &= FMT_IMPL;
 	f->flags |= FMT_ARG;
 	f->parastate = PARA_MID;
@@ -76,7 +76,7 @@ void
 macro_close(struct format *f)
 {
 	if (f->linestate != LINE_NEW)
-		putchar('\n');
+		sink_putc(f->out, '\n');
 	f->linestate = LINE_NEW;
 	f->flags = 0;
 }
@@ -109,10 +109,10 @@ macro_addarg(struct format *f, const char *arg, int flags)
 				break;
 		if (*cp != '\0') {
 			if (flags & ARG_SPACE) {
-				putchar(' ');
+				sink_putc(f->out, ' ');
 				flags &= ~ ARG_SPACE;
 			}
-			putchar('"');
+			sink_putc(f->out, '"');
 			flags = ARG_QUOTED;
 			quote_now = 1;
 		}
@@ -126,7 +126,7 @@ macro_addarg(struct format *f, const char *arg, int flags)
 			flags |= ARG_SPACE;
 			continue;
 		} else if (flags & ARG_SPACE) {
-			putchar(' ');
+			sink_putc(f->out, ' ');
 			flags &= ~ ARG_SPACE;
 		}
 
@@ -142,19 +142,19 @@ macro_addarg(struct format *f, const char *arg, int flags)
 		       strncmp(cp, "Bro", 3) == 0 ||
 		       strncmp(cp, "Brc", 3) == 0 ||
 		       strncmp(cp, "Bsx", 3) == 0))))
-			fputs("\\&", stdout);
+			sink_puts(f->out, "\\&");
 
 		if (*cp == '"')
-			fputs("\\(dq", stdout);
+			sink_puts(f->out, "\\(dq");
 		else if (flags & ARG_UPPER)
-			putchar(toupper((unsigned char)*cp));
+			sink_putc(f->out, toupper((unsigned char)*cp));
 		else
-			putchar(*cp);
+			sink_putc(f->out, *cp);
 		if (*cp == '\\')
-			putchar('e');
+			sink_putc(f->out, 'e');
 	}
 	if (quote_now)
-		putchar('"');
+		sink_putc(f->out, '"');
 	f->parastate = PARA_MID;
 }
 
@@ -182,12 +182,12 @@ macro_addnode(struct format *f, struct pnode *n, int flags)
 	 * that text, letting macro_addarg() decide about quoting.
 	 */
 
-	while ((nc = TAILQ_FIRST(&n->childq)) != NULL &&
-	    TAILQ_NEXT(nc, child) == NULL)
+	while ((nc = PNODE_FIRST(n)) != NULL &&
+	    PNODE_NEXT(nc) == NULL)
 		n = nc;
 
 	if (n->node == NODE_TEXT || n->node == NODE_ESCAPE) {
-		macro_addarg(f, n->b, flags);
+		macro_addarg(f, n->u.b, flags);
 		f->parastate = PARA_MID;
 		return;
 	}
@@ -201,10 +201,10 @@ macro_addnode(struct format *f, struct pnode *n, int flags)
 	if (flags & ARG_SINGLE) {
 		if ((flags & ARG_QUOTED) == 0) {
 			if (flags & ARG_SPACE) {
-				putchar(' ');
+				sink_putc(f->out, ' ');
 				flags &= ~ARG_SPACE;
 			}
-			putchar('"');
+			sink_putc(f->out, '"');
 			flags |= ARG_QUOTED;
 			quote_now = 1;
 		}
@@ -218,9 +218,9 @@ macro_addnode(struct format *f, struct pnode *n, int flags)
 
 	while (nc != NULL) {
 		macro_addnode(f, nc, flags);
-		is_text = pnode_class(nc->node) == CLASS_TEXT;
-		nc = TAILQ_NEXT(nc, child);
-		if (nc == NULL || pnode_class(nc->node) != CLASS_TEXT)
+		is_text = nc->class == CLASS_TEXT;
+		nc = PNODE_NEXT(nc);
+		if (nc == NULL || nc->class != CLASS_TEXT)
 			is_text = 0;
 		if (is_text && (nc->flags & NFLAG_SPC) == 0)
 			flags &= ~ARG_SPACE;
@@ -228,7 +228,7 @@ macro_addnode(struct format *f, struct pnode *n, int flags)
 			flags |= ARG_SPACE;
 	}
 	if (quote_now)
-		putchar('"');
+		sink_putc(f->out, '"');
 	f->parastate = PARA_MID;
 }
 
@@ -256,14 +256,14 @@ print_text(struct format *f, const char *word, int flags)
 		break;
 	case LINE_TEXT:
 		if (flags & ARG_SPACE)
-			putchar(' ');
+			sink_putc(f->out, ' ');
 		break;
 	case LINE_MACRO:
 		macro_close(f);
 		break;
 	}
 	if (f->linestate == LINE_NEW && (*word == '.' || *word == '\''))
-		fputs("\\&", stdout);
+		sink_puts(f->out, "\\&");
 	ateos = inword = 0;
 	while (*word != '\0') {
 		if (f->nofill == 0) {
@@ -282,10 +282,10 @@ print_text(struct format *f, const char *word, int flags)
 					break;
 				case '\'':
 				case '.':
-					fputs("\n\\&", stdout);
+					sink_puts(f->out, "\n\\&");
 					break;
 				default:
-					putchar('\n');
+					sink_putc(f->out, '\n');
 					break;
 				}
 				continue;
@@ -311,9 +311,9 @@ print_text(struct format *f, const char *word, int flags)
 				break;
 			}
 		}
-		putchar(*word);
+		sink_putc(f->out, *word);
 		if (*word++ == '\\')
-			putchar('e');
+			sink_putc(f->out, 'e');
 	}
 	f->linestate = LINE_TEXT;
 	f->parastate = PARA_MID;
@@ -329,8 +329,8 @@ print_textnode(struct format *f, struct pnode *n)
 	struct pnode	*nc;
 
 	if (n->node == NODE_TEXT || n->node == NODE_ESCAPE)
-		print_text(f, n->b, ARG_SPACE);
+		print_text(f, n->u.b, ARG_SPACE);
 	else
-		TAILQ_FOREACH(nc, &n->childq, child)
+		PNODE_FOREACH(nc, n)
 			print_textnode(f, nc);
 }
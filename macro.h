@@ -33,6 +33,7 @@ enum	parastate {
 };
 
 struct	format {
+	struct sink	*out;        /* Where to write the output. */
 	int		 level;      /* Header level, starting at 1. */
 	int		 nofill;     /* Level of no-fill block nesting. */
 	int		 flags;
@@ -15,16 +15,30 @@
  * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
+#include <sys/stat.h>
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <getopt.h>
 #include <libgen.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
+#include "xmalloc.h"
+#include "hash.h"
 #include "node.h"
 #include "parse.h"
 #include "reorg.h"
+#include "sink.h"
+#include "cache.h"
 #include "format.h"
+#include "pool.h"
+#include "server.h"
 
 /*
  * The steering function of the docbook2mdoc(1) program.
@@ -36,36 +50,564 @@ enum	outt {
 	OUTT_LINT
 };
 
-int
-main(int argc, char *argv[])
+struct	options {
+	const char	*progname;
+	const char	*outdir;   /* Output directory or NULL for stdout. */
+	const char	*server;   /* Server socket from -S or NULL. */
+	const char	*depfile;  /* Dependency file from -M or NULL. */
+	const char	*cachedir; /* Cache directory from -C or NULL. */
+	struct pcache	*pcache;   /* Parse trees of included files. */
+	struct arena	*arena;    /* Storage for one parse tree at a time. */
+	const char	*sec;      /* Manual section from -s or NULL. */
+	enum outt	 outtype;
+	int		 jobs;     /* Number of worker processes. */
+	int		 warn;
+};
+
+struct	inputs {
+	char		**names;   /* Input file names. */
+	size_t		  sz;      /* Number of input files. */
+	size_t		  max;     /* Allocated size of names[]. */
+};
+
+/*
+ * An output file name used in the current run.
+ */
+struct	oname {
+	char		*name;     /* File name or NULL if the slot is free. */
+	size_t		 job;      /* Index of the input file writing it. */
+};
+
+/*
+ * Converting a list of input files, with or without worker processes.
+ * With -o, each output file is written to a temporary file first,
+ * and renamed into place in the order of the input files, such that
+ * the first input file using an output file name always wins.
+ */
+struct	batch {
+	const struct options *opts;
+	struct inputs	*in;
+	struct sink	*dep;      /* Dependency rules or NULL. */
+	struct oname	*onames;   /* Hash table of output file names. */
+	size_t		 omax;     /* Number of slots, a power of 2. */
+	pid_t		 pid;      /* Process writing the temporary files. */
+};
+
+
+static void
+input_add(struct inputs *in, const char *name)
+{
+	if (in->sz == in->max) {
+		in->max = in->max == 0 ? 16 : in->max * 2;
+		in->names = xreallocarray(in->names,
+		    in->max, sizeof(*in->names));
+	}
+	in->names[in->sz++] = xstrdup(name);
+}
+
+/*
+ * Parser callback recording each file it tries to open.
+ */
+static void
+dep_add(void *arg, const char *name, int found, const struct stat *st)
+{
+	centry_adddep(arg, name, found, st);
+}
+
+/*
+ * Parser callback collecting messages in memory.
+ */
+static void
+msg_add(void *arg, const char *fname, int line, int col,
+    int level, const char *text)
+{
+	sink_printf(arg, "%s:%d:%d: %s: %s\n", fname, line, col,
+	    level == MSG_ERROR ? "ERROR" : "WARNING", text);
+}
+
+/*
+ * Write a file name to a dependency file,
+ * escaping characters that are special to make(1).
+ */
+static void
+dep_name(struct sink *out, const char *name)
+{
+	for (; *name != '\0'; name++) {
+		switch (*name) {
+		case ' ':
+		case '\t':
+		case '#':
+		case '\\':
+			sink_putc(out, '\\');
+			break;
+		case '$':
+			sink_putc(out, '$');
+			break;
+		default:
+			break;
+		}
+		sink_putc(out, *name);
+	}
+}
+
+/*
+ * Write a make(1) rule stating that the target depends
+ * on all the files read for ce, and an empty rule for each
+ * included file, such that deleting it does not break make(1).
+ */
+static void
+dep_write(struct sink *out, const char *target, const struct centry *ce)
+{
+	size_t		 i;
+
+	dep_name(out, target);
+	sink_putc(out, ':');
+	for (i = 0; i < ce->depsz; i++) {
+		if (ce->deps[i].found == 0)
+			continue;
+		sink_puts(out, " \\\n\t");
+		dep_name(out, ce->deps[i].path);
+	}
+	sink_putc(out, '\n');
+	for (i = 1; i < ce->depsz; i++) {
+		if (ce->deps[i].found == 0)
+			continue;
+		sink_putc(out, '\n');
+		dep_name(out, ce->deps[i].path);
+		sink_puts(out, ":\n");
+	}
+}
+
+static int
+input_select(const struct dirent *dp)
+{
+	size_t		 sz;
+
+	if (dp->d_name[0] == '.')
+		return 0;
+	sz = strlen(dp->d_name);
+	return sz > 4 && strcmp(dp->d_name + sz - 4, ".xml") == 0;
+}
+
+/*
+ * Add one command line argument to the list of input files.
+ * A directory stands for all "*.xml" files contained in it,
+ * in alphabetical order.
+ */
+static int
+input_arg(struct inputs *in, const char *arg)
+{
+	struct dirent	**dps;
+	struct stat	  st;
+	char		 *path;
+	int		  i, nd;
+
+	if (stat(arg, &st) == -1 || S_ISDIR(st.st_mode) == 0) {
+		input_add(in, arg);
+		return 0;
+	}
+	if ((nd = scandir(arg, &dps, input_select, alphasort)) == -1) {
+		fprintf(stderr, "%s: %s\n", arg, strerror(errno));
+		return -1;
+	}
+	for (i = 0; i < nd; i++) {
+		xasprintf(&path, "%s/%s", arg, dps[i]->d_name);
+		input_add(in, path);
+		free(path);
+		free(dps[i]);
+	}
+	free(dps);
+	return 0;
+}
+
+/*
+ * Append len bytes of text to a file name,
+ * replacing characters that are unsafe in file names.
+ */
+static void
+outname_add(char **name, size_t *sz, const char *text, size_t len)
+{
+	const char	*cp;
+
+	*name = xrealloc(*name, *sz + len + 1);
+	for (cp = text; cp < text + len; cp++)
+		(*name)[(*sz)++] = *cp == '/' ||
+		    isspace((unsigned char)*cp) ? '_' : *cp;
+	(*name)[*sz] = '\0';
+}
+
+/*
+ * Append the text contained in a node to a file name.
+ */
+static void
+outname_text(char **name, size_t *sz, struct pnode *n)
+{
+	struct pnode	*nc;
+
+	if (n->node == NODE_TEXT)
+		outname_add(name, sz, n->u.b, strlen(n->u.b));
+	PNODE_FOREACH(nc, n)
+		outname_text(name, sz, nc);
+}
+
+/*
+ * Construct the output file name "title.section"
+ * from the arguments of the .Dt macro collected by ptree_reorg().
+ * If the document has no title, use the name of the input file fname
+ * instead, without the directory and the ".xml" suffix, unless fname
+ * is NULL.
+ */
+static char *
+outname(struct ptree *tree, const char *fname)
+{
+	struct pnode	*nc, *title, *vol;
+	const char	*cp;
+	char		*name, *sec, *path;
+	size_t		 namesz, secsz, len;
+
+	title = vol = NULL;
+	PNODE_FOREACH(nc, tree->root) {
+		if (nc->node == NODE_REFENTRYTITLE && title == NULL)
+			title = nc;
+		else if (nc->node == NODE_MANVOLNUM && vol == NULL)
+			vol = nc;
+	}
+	name = sec = NULL;
+	namesz = secsz = 0;
+	if (title != NULL && (tree->flags & TREE_NOTITLE) == 0)
+		outname_text(&name, &namesz, title);
+	if (namesz == 0 && fname != NULL) {
+		if ((cp = strrchr(fname, '/')) != NULL)
+			fname = cp + 1;
+		len = strlen(fname);
+		if (len > 4 && strcmp(fname + len - 4, ".xml") == 0)
+			len -= 4;
+		outname_add(&name, &namesz, fname, len);
+	}
+	if (vol != NULL)
+		outname_text(&sec, &secsz, vol);
+	xasprintf(&path, "%s.%s",
+	    namesz ? name : "UNKNOWN", secsz ? sec : "1");
+	free(name);
+	free(sec);
+	return path;
+}
+
+/*
+ * Parse, reorganize, and format one input document into ce.
+ * If buf is not NULL, it holds the contents of the file fname
+ * as opened with status st, and messages are collected in ce
+ * rather than printed.
+ */
+static void
+convert_parse(const struct options *opts, const char *fname, int fd,
+    const char *buf, size_t sz, const struct stat *st, struct centry *ce)
 {
 	struct parse	*parser;
 	struct ptree	*tree;
-	const char	*progname;
-	const char	*bname, *fname, *sec;
-	int		 ch, fd, rc, warn;
-	enum outt	 outtype;
 
-	if ((progname = strrchr(argv[0], '/')) == NULL)
-		progname = argv[0];
+	parser = parse_alloc(opts->warn);
+	parse_setcache(parser, opts->pcache);
+	parse_setarena(parser, opts->arena);
+	parse_setfile(parser, dep_add, ce);
+	if (buf != NULL) {
+		parse_setmsg(parser, msg_add, &ce->msgs);
+		centry_adddep(ce, fname, 1, st);
+		tree = parse_buf(parser, buf, sz, fname);
+	} else
+		tree = parse_file(parser, fd, fname);
+	ptree_reorg(tree, opts->sec);
+	ce->rc = tree->flags & TREE_ERROR ? 3 :
+	    tree->flags & TREE_WARN ? 2 : 0;
+	if (tree->root != NULL) {
+		ce->oname = outname(tree, fd == -1 ? fname : NULL);
+		if (opts->outtype == OUTT_MDOC)
+			ptree_print_mdoc(tree, &ce->out);
+		else if (opts->outtype == OUTT_TREE)
+			ptree_print_tree(tree, &ce->out);
+	}
+	parse_free(parser);
+	arena_reset(opts->arena);
+}
+
+/*
+ * Print the messages and write the output for one document.
+ * With -o, write to the file tmpname instead if it is not NULL.
+ * Unless dep is NULL, write a make(1) rule listing the files read.
+ * Return the exit status for this document.
+ */
+static int
+convert_emit(const struct options *opts, const char *fname, int fd,
+    const struct centry *ce, struct sink *dep, const char *tmpname)
+{
+	struct sink	 out;
+	const char	*bname;
+	char		*oname;
+	int		 ofd, rc;
+
+	rc = ce->rc;
+	fwrite(ce->msgs.b, 1, ce->msgs.len, stderr);
+	if (ce->oname == NULL)
+		return rc;
+	if (opts->outdir == NULL)
+		oname = xstrdup(ce->oname);
 	else
-		progname++;
+		xasprintf(&oname, "%s/%s", opts->outdir, ce->oname);
+	if (dep != NULL)
+		dep_write(dep, oname, ce);
+
+	if (opts->outtype != OUTT_LINT) {
+		ofd = STDOUT_FILENO;
+		if (opts->outdir != NULL && (ofd = open(tmpname == NULL ?
+		    oname : tmpname, O_WRONLY | O_CREAT | O_TRUNC,
+		    0666)) == -1) {
+			fprintf(stderr, "%s: open: %s\n",
+			    oname, strerror(errno));
+			free(oname);
+			return 4;
+		}
+		sink_init_fd(&out, ofd);
+		if (rc > 2)
+			fputc('\n', stderr);
+		if (opts->outtype == OUTT_MDOC && fd == -1 &&
+		    (bname = basename(fname)) != NULL)
+			sink_printf(&out, ".\\\" automatically "
+			    "generated with %s %s\n", opts->progname, bname);
+		sink_write(&out, ce->out.b, ce->out.len);
+		if (rc > 2)
+			fputs("\nThe output may be incomplete, see the "
+			    "parse error reported above.\n\n", stderr);
+		if (sink_flush(&out) == -1) {
+			fprintf(stderr, "%s: write: %s\n",
+			    opts->outdir == NULL ? "<stdout>" : oname,
+			    strerror(out.error));
+			rc = 4;
+		}
+		sink_free(&out);
+		if (opts->outdir != NULL)
+			close(ofd);
+	}
+	free(oname);
+	return rc;
+}
+
+/*
+ * Convert one input document, using the cache if possible,
+ * passing tmpname on to convert_emit().  If an output file
+ * was written and onamep is not NULL, store its name there.
+ * Return the exit status for this document.
+ */
+static int
+convert(const struct options *opts, const char *fname, int fd,
+    struct sink *dep, const char *tmpname, char **onamep)
+{
+	struct centry	 ce;
+	struct stat	 st;
+	char		*buf, *key;
+	char		 hex[HASH_HEXSZ];
+	size_t		 sz;
+	int		 rc;
+
+	centry_init(&ce);
+	buf = NULL;
+	if (opts->cachedir != NULL && fd == -1 &&
+	    (buf = cache_readfile(fname, &sz, &st)) != NULL) {
+		xasprintf(&key, "T%d W%d s%s", opts->outtype, opts->warn,
+		    opts->sec == NULL ? "" : opts->sec);
+		cache_key(hex, key, fname, buf, sz);
+		free(key);
+		if (cache_get(opts->cachedir, hex, &ce) == -1) {
+			convert_parse(opts, fname, fd, buf, sz, &st, &ce);
+			cache_put(opts->cachedir, hex, &ce);
+		}
+	} else
+		convert_parse(opts, fname, fd, NULL, 0, NULL, &ce);
+	rc = convert_emit(opts, fname, fd, &ce, dep, tmpname);
+	if (onamep != NULL && opts->outdir != NULL &&
+	    opts->outtype != OUTT_LINT && ce.oname != NULL && rc < 4)
+		*onamep = xstrdup(ce.oname);
+	centry_free(&ce);
+	free(buf);
+	return rc;
+}
+
+/*
+ * Return the name of the temporary output file for input file i,
+ * or NULL if no output files are written.
+ */
+static char *
+batch_tmpname(const struct batch *b, size_t i)
+{
+	char		*tmp;
+
+	if (b->opts->outdir == NULL || b->opts->outtype == OUTT_LINT)
+		return NULL;
+	xasprintf(&tmp, "%s/.docbook2mdoc.%ld.%zu",
+	    b->opts->outdir, (long)b->pid, i);
+	return tmp;
+}
+
+/*
+ * Look up the output file name in the hash table of the batch b,
+ * and if it is not there yet, enter it as used by input file i.
+ * Return the input file using it first.
+ */
+static size_t
+batch_claim(struct batch *b, const char *name, size_t i)
+{
+	const char	*cp;
+	size_t		 h;
+
+	h = 2166136261U;
+	for (cp = name; *cp != '\0'; cp++)
+		h = (h ^ (unsigned char)*cp) * 16777619U;
+	for (h &= b->omax - 1; b->onames[h].name != NULL;
+	    h = (h + 1) & (b->omax - 1))
+		if (strcmp(b->onames[h].name, name) == 0)
+			return b->onames[h].job;
+	b->onames[h].name = xstrdup(name);
+	b->onames[h].job = i;
+	return i;
+}
+
+/*
+ * Convert one file from the input list, possibly in a worker process.
+ * Write the name of the output file written, or an empty line if none
+ * was written, followed by the dependency rules, to data.
+ */
+static int
+convert_job(size_t i, void *arg, struct sink *data)
+{
+	struct batch	*b;
+	struct sink	 dep;
+	char		*oname, *tmp;
+	int		 rc;
+
+	b = arg;
+	tmp = batch_tmpname(b, i);
+	oname = NULL;
+	sink_init_buf(&dep);
+	rc = convert(b->opts, b->in->names[i], -1,
+	    b->dep == NULL ? NULL : &dep, tmp, &oname);
+	sink_printf(data, "%s\n", oname == NULL ? "" : oname);
+	sink_write(data, dep.b, dep.len);
+	sink_free(&dep);
+	free(oname);
+	free(tmp);
+	return rc;
+}
 
-	sec = NULL;
-	warn = 0;
-	outtype = OUTT_MDOC;
-	while ((ch = getopt(argc, argv, "s:T:W")) != -1) {
+/*
+ * In the parent process and in the order of the input files,
+ * rename the output file written for input file i into place
+ * unless an earlier input file already used the same name,
+ * and pass on the dependency rules.
+ */
+static int
+batch_done(size_t i, void *arg, const char *data, size_t len)
+{
+	struct batch	*b;
+	const char	*eol;
+	char		*name, *path, *tmp;
+	size_t		 first;
+	int		 rc;
+
+	b = arg;
+	rc = 0;
+	tmp = batch_tmpname(b, i);
+	if (data == NULL || (eol = memchr(data, '\n', len)) == NULL) {
+		if (tmp != NULL)
+			unlink(tmp);
+		free(tmp);
+		return rc;
+	}
+	if (eol > data) {
+		name = xstrndup(data, eol - data);
+		xasprintf(&path, "%s/%s", b->opts->outdir, name);
+		if ((first = batch_claim(b, name, i)) != i) {
+			fprintf(stderr, "%s: %s: Output file name already "
+			    "used for %s\n", b->in->names[i], path,
+			    b->in->names[first]);
+			unlink(tmp);
+			rc = 4;
+		} else if (rename(tmp, path) == -1) {
+			fprintf(stderr, "%s: rename: %s\n",
+			    path, strerror(errno));
+			unlink(tmp);
+			rc = 4;
+		}
+		free(path);
+		free(name);
+	} else if (tmp != NULL)
+		unlink(tmp);
+	if (rc == 0 && b->dep != NULL)
+		sink_write(b->dep, eol + 1, data + len - eol - 1);
+	free(tmp);
+	return rc;
+}
+
+int
+main(int argc, char *argv[])
+{
+	struct options	 opts;
+	struct inputs	 in;
+	struct batch	 batch;
+	struct sink	 data, dep;
+	const char	*errstr;
+	size_t		 i;
+	int		 ch, dfd, other, rc, rc1;
+
+	if ((opts.progname = strrchr(argv[0], '/')) == NULL)
+		opts.progname = argv[0];
+	else
+		opts.progname++;
+
+	opts.outdir = NULL;
+	opts.server = NULL;
+	opts.depfile = NULL;
+	opts.cachedir = NULL;
+	opts.sec = NULL;
+	opts.warn = 0;
+	opts.jobs = 1;
+	opts.outtype = OUTT_MDOC;
+	other = 0;
+	while ((ch = getopt(argc, argv, "C:j:M:o:S:s:T:W")) != -1) {
+		if (ch != 'S')
+			other = ch;
 		switch (ch) {
+		case 'C':
+			opts.cachedir = optarg;
+			break;
+		case 'j':
+			opts.jobs = strtonum(optarg, 0, 1024, &errstr);
+			if (errstr != NULL) {
+				fprintf(stderr, "%s: Bad argument\n",
+				    optarg);
+				goto usage;
+			}
+			if (opts.jobs == 0 &&
+			    (opts.jobs = sysconf(_SC_NPROCESSORS_ONLN)) < 1)
+				opts.jobs = 1;
+			break;
+		case 'M':
+			opts.depfile = optarg;
+			break;
+		case 'o':
+			opts.outdir = optarg;
+			break;
+		case 'S':
+			opts.server = optarg;
+			break;
 		case 's':
-			sec = optarg;
+			opts.sec = optarg;
 			break;
 		case 'T':
 			if (strcmp(optarg, "mdoc") == 0)
-				outtype = OUTT_MDOC;
+				opts.outtype = OUTT_MDOC;
 			else if (strcmp(optarg, "tree") == 0)
-				outtype = OUTT_TREE;
+				opts.outtype = OUTT_TREE;
 			else if (strcmp(optarg, "lint") == 0)
-				outtype = OUTT_LINT;
+				opts.outtype = OUTT_LINT;
 			else {
 				fprintf(stderr, "%s: Bad argument\n",
 				    optarg);
@@ -73,7 +615,7 @@ main(int argc, char *argv[])
 			}
 			break;
 		case 'W':
-			warn = 1;
+			opts.warn = 1;
 			break;
 		default:
 			goto usage;
@@ -82,50 +624,110 @@ main(int argc, char *argv[])
 	argc -= optind;
 	argv += optind;
 
+	/* In server mode, the requests provide the input. */
+
+	if (opts.server != NULL) {
+		if (argc > 0) {
+			fprintf(stderr, "%s: Too many arguments with -S\n",
+			    opts.progname);
+			goto usage;
+		}
+		if (other != 0) {
+			fprintf(stderr, "%s: -%c cannot be used with -S\n",
+			    opts.progname, other);
+			goto usage;
+		}
+		return server_run(opts.server);
+	}
+
 	/*
 	 * Argument processing:
-	 * Open file or use standard input.
+	 * Collect input files or use standard input.
+	 * More than one input file requires an output directory.
 	 */
 
-	if (argc > 1) {
-		fprintf(stderr, "%s: Too many arguments\n", argv[1]);
+	memset(&in, 0, sizeof(in));
+	for (ch = 0; ch < argc; ch++)
+		if (input_arg(&in, argv[ch]) == -1)
+			return 5;
+	if (in.sz > 1 && opts.outdir == NULL) {
+		fprintf(stderr, "%s: Too many arguments without -o\n",
+		    in.names[1]);
 		goto usage;
-	} else if (argc == 1) {
-		fname = argv[0];
-		fd = -1;
-	} else {
-		fname = "<stdin>";
-		fd = STDIN_FILENO;
 	}
 
-	/* Parse. */
+	if (opts.cachedir != NULL &&
+	    mkdir(opts.cachedir, 0777) == -1 && errno != EEXIST) {
+		fprintf(stderr, "%s: mkdir: %s\n",
+		    opts.cachedir, strerror(errno));
+		return 4;
+	}
 
-	parser = parse_alloc(warn);
-	tree = parse_file(parser, fd, fname);
-	ptree_reorg(tree, sec);
-	rc = tree->flags & TREE_ERROR ? 3 : tree->flags & TREE_WARN ? 2 : 0;
+	opts.pcache = pcache_alloc(opts.cachedir);
+	opts.arena = arena_alloc();
+	dfd = -1;
+	if (opts.depfile != NULL) {
+		if ((dfd = open(opts.depfile,
+		    O_WRONLY | O_CREAT | O_TRUNC, 0666)) == -1) {
+			fprintf(stderr, "%s: open: %s\n",
+			    opts.depfile, strerror(errno));
+			return 4;
+		}
+		sink_init_fd(&dep, dfd);
+	}
 
-	/* Format. */
+	if (in.sz == 0)
+		rc = convert(&opts, "<stdin>", STDIN_FILENO,
+		    opts.depfile == NULL ? NULL : &dep, NULL, NULL);
+	else {
+		batch.opts = &opts;
+		batch.in = &in;
+		batch.dep = opts.depfile == NULL ? NULL : &dep;
+		for (batch.omax = 16; batch.omax < in.sz * 2; batch.omax *= 2)
+			continue;
+		batch.onames = xcalloc(batch.omax, sizeof(*batch.onames));
+		batch.pid = getpid();
+		if (in.sz > 1 && opts.jobs > 1)
+			rc = pool_run(opts.jobs, in.sz, in.names,
+			    convert_job, batch_done, &batch);
+		else {
+			rc = 0;
+			for (i = 0; i < in.sz; i++) {
+				sink_init_buf(&data);
+				if ((rc1 = convert_job(i, &batch, &data)) > rc)
+					rc = rc1;
+				if ((rc1 = batch_done(i, &batch,
+				    data.b, data.len)) > rc)
+					rc = rc1;
+				sink_free(&data);
+			}
+		}
+		for (i = 0; i < batch.omax; i++)
+			free(batch.onames[i].name);
+		free(batch.onames);
+		for (i = 0; i < in.sz; i++)
+			free(in.names[i]);
+		free(in.names);
+	}
 
-	if (outtype != OUTT_LINT && tree->root != NULL) {
-		if (rc > 2)
-			fputc('\n', stderr);
-		if (outtype == OUTT_MDOC) {
-			if (fd == -1 && (bname = basename(fname)) != NULL)
-				printf(".\\\" automatically generated "
-				    "with %s %s\n", progname, bname);
-			ptree_print_mdoc(tree);
-		} else
-			ptree_print_tree(tree);
-		if (rc > 2)
-			fputs("\nThe output may be incomplete, see the "
-			    "parse error reported above.\n\n", stderr);
+	if (opts.depfile != NULL) {
+		if (sink_flush(&dep) == -1) {
+			fprintf(stderr, "%s: write: %s\n",
+			    opts.depfile, strerror(dep.error));
+			rc = 4;
+		}
+		sink_free(&dep);
+		close(dfd);
 	}
-	parse_free(parser);
+	pcache_free(opts.pcache);
+	arena_free(opts.arena);
 	return rc;
 
 usage:
-	fprintf(stderr, "usage: %s [-W] [-s section] "
-	    "[-T mdoc | tree | lint] [input_filename]\n", progname);
+	fprintf(stderr, "usage: %s [-W] [-C cachedir] [-j jobs] "
+	    "[-M depfile] [-o directory]\n"
+	    "       [-s section] [-T mdoc | tree | lint] "
+	    "[input_filename ...]\n"
+	    "       %s -S socket\n", opts.progname, opts.progname);
 	return 5;
 }
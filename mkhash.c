@@ -0,0 +1,226 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "node.h"
+#include "phash.h"
+#include "names.h"
+#include "entities.h"
+
+/*
+ * Generate the perfect hash tables of the names in names.h for
+ * nametab.h, or with the argument "entities", of the entity names
+ * in entities.h for enttab.h.
+ * Each name hashes to a bucket; the buckets are placed in decreasing
+ * order of size, each with the first seed that maps all of its names
+ * to free slots.  Start with one slot per name and double the number
+ * of slots until every bucket finds a seed.
+ */
+
+#define	NAMES_MAX	4096	/* Must fit into a slot. */
+
+static	const char	*names[NAMES_MAX];
+static	unsigned char	 disp[NAMES_MAX * 2];
+static	unsigned short	 slot[NAMES_MAX * 4];
+
+
+/*
+ * Try to place all names with dbits bucket bits and sbits slot bits.
+ * Return 1 on success or 0 if some bucket finds no seed.
+ */
+static int
+place(size_t n, unsigned int dbits, unsigned int sbits)
+{
+	size_t		 bucket[NAMES_MAX], bsz[NAMES_MAX * 2];
+	size_t		 i, j, k, b, bmax;
+	unsigned int	 d, dmask, smask, s[NAMES_MAX];
+
+	dmask = (1U << dbits) - 1;
+	smask = (1U << sbits) - 1;
+	memset(disp, 0, sizeof(disp));
+	memset(slot, 0, sizeof(slot));
+	memset(bsz, 0, sizeof(bsz));
+	for (i = 0; i < n; i++)
+		bsz[bucket[i] = name_hash(names[i], 0) & dmask]++;
+
+	for (bmax = n; bmax > 0; bmax--) {
+		for (b = 0; b <= dmask; b++) {
+			if (bsz[b] != bmax)
+				continue;
+			for (d = 1; d < 256; d++) {
+				for (i = k = 0; i < n; i++) {
+					if (bucket[i] != b)
+						continue;
+					s[k] = name_hash(names[i], d) & smask;
+					if (slot[s[k]] != 0)
+						break;
+					for (j = 0; j < k; j++)
+						if (s[j] == s[k])
+							break;
+					if (j < k)
+						break;
+					k++;
+				}
+				if (i == n)
+					break;
+			}
+			if (d == 256)
+				return 0;
+			disp[b] = d;
+			for (i = k = 0; i < n; i++)
+				if (bucket[i] == b)
+					slot[s[k++]] = i + 1;
+		}
+	}
+	return 1;
+}
+
+static void
+print_disp(const char *name, size_t sz)
+{
+	size_t		 i;
+
+	printf("static\tconst unsigned char %sdisp[%zu] = {", name, sz);
+	for (i = 0; i < sz; i++)
+		printf("%s%3u%s", i % 12 ? " " : "\n\t", disp[i],
+		    i + 1 < sz ? "," : "\n");
+	printf("};\n\n");
+}
+
+static void
+print_slot(const char *name, size_t sz)
+{
+	size_t		 i;
+
+	printf("static\tconst unsigned short %sslot[%zu] = {", name, sz);
+	for (i = 0; i < sz; i++)
+		printf("%s%4u%s", i % 10 ? " " : "\n\t", slot[i],
+		    i + 1 < sz ? "," : "\n");
+	printf("};\n\n");
+}
+
+/*
+ * Generate the table called name for the first n entries of names[].
+ */
+static int
+gen(const char *name, size_t n)
+{
+	struct nametab	 t;
+	size_t		 i, j;
+	unsigned int	 dbits, sbits;
+
+	if (n > NAMES_MAX) {
+		fprintf(stderr, "%s: Too many names\n", name);
+		return 0;
+	}
+	for (i = 0; i < n; i++) {
+		if (names[i] == NULL) {
+			fprintf(stderr, "%s: Missing name %zu\n", name, i);
+			return 0;
+		}
+		for (j = 0; j < i; j++) {
+			if (strcmp(names[i], names[j]) == 0) {
+				fprintf(stderr, "%s: Duplicate name %s\n",
+				    name, names[i]);
+				return 0;
+			}
+		}
+	}
+	for (sbits = 0; (1U << sbits) < n; sbits++)
+		continue;
+	for (;; sbits++) {
+		if ((1U << sbits) > sizeof(slot) / sizeof(slot[0])) {
+			fprintf(stderr, "%s: No perfect hash found\n", name);
+			return 0;
+		}
+		dbits = sbits > 1 ? sbits - 1 : 0;
+		if (place(n, dbits, sbits))
+			break;
+	}
+	print_disp(name, 1U << dbits);
+	print_slot(name, 1U << sbits);
+	printf("static\tconst struct nametab %stab = {\n"
+	    "\t%sdisp, %sslot, %u, %u\n};\n", name, name, name, dbits, sbits);
+
+	/* Check that lookups find all names as placed. */
+
+	t.disp = disp;
+	t.slot = slot;
+	t.dbits = dbits;
+	t.sbits = sbits;
+	for (i = 0; i < n; i++) {
+		if (name_find(&t, names[i]) != (int)i) {
+			fprintf(stderr, "%s: Lookup failed for %s\n",
+			    name, names[i]);
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int
+main(int argc, char *argv[])
+{
+	size_t		 i, n;
+
+	if (argc > 1 && strcmp(argv[1], "entities") == 0) {
+		printf("/* This file is generated by mkhash "
+		    "from entities.h. */\n\n");
+		n = sizeof(entities) / sizeof(entities[0]);
+		for (i = 0; i < n && i < NAMES_MAX; i++)
+			names[i] = entities[i].name;
+		return gen("entity", n) == 0;
+	} else if (argc > 1) {
+		fputs("usage: mkhash [entities]\n", stderr);
+		return 1;
+	}
+
+	if (sizeof(properties) / sizeof(properties[0]) != NODE_IGNORE) {
+		fputs("properties[] does not match enum nodeid\n", stderr);
+		return 1;
+	}
+	printf("/* This file is generated by mkhash from names.h. */\n");
+
+	printf("\n/* Element names, up to NODE_UNKNOWN. */\n");
+	for (i = 0; i < NODE_UNKNOWN; i++)
+		names[i] = properties[i].name;
+	if (gen("node", NODE_UNKNOWN) == 0)
+		return 1;
+
+	printf("\n/* Element aliases. */\n");
+	n = sizeof(aliases) / sizeof(aliases[0]);
+	for (i = 0; i < n && i < NAMES_MAX; i++)
+		names[i] = aliases[i].name;
+	if (gen("alias", n) == 0)
+		return 1;
+
+	printf("\n/* Attribute keys. */\n");
+	for (i = 0; i < ATTRKEY__MAX; i++)
+		names[i] = attrkeys[i];
+	if (gen("attrkey", ATTRKEY__MAX) == 0)
+		return 1;
+
+	printf("\n/* Attribute values. */\n");
+	for (i = 0; i < ATTRVAL__MAX; i++)
+		names[i] = attrvals[i];
+	if (gen("attrval", ATTRVAL__MAX) == 0)
+		return 1;
+	return 0;
+}
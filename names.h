@@ -0,0 +1,260 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2014 Kristaps Dzonsons <kristaps@bsd.lv>
+ * Copyright (c) 2019 Ingo Schwarze <schwarze@openbsd.org>
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * The names of elements, aliases, attribute keys and attribute values,
+ * shared by node.c and by mkhash, which generates the hash tables
+ * in nametab.h from them.  Run "make nametab.h" after changing them.
+ */
+
+struct	nodeprop {
+	const char	*name;
+	enum nodeclass	 class;
+};
+
+static	const struct nodeprop properties[] = {
+	{ "abstract",		CLASS_BLOCK },
+	{ "appendix",		CLASS_BLOCK },
+	{ "arg",		CLASS_ENCL },
+	{ "author",		CLASS_LINE },
+	{ "authorgroup",	CLASS_BLOCK },
+	{ "blockquote",		CLASS_BLOCK },
+	{ "bookinfo",		CLASS_BLOCK },
+	{ "caution",		CLASS_BLOCK },
+	{ "citerefentry",	CLASS_LINE },
+	{ "citetitle",		CLASS_LINE },
+	{ "cmdsynopsis",	CLASS_TRANS },
+	{ "colspec",		CLASS_VOID },
+	{ "command",		CLASS_LINE },
+	{ "constant",		CLASS_LINE },
+	{ "contrib",		CLASS_TRANS },
+	{ "copyright",		CLASS_LINE },
+	{ "date",		CLASS_TRANS },
+	{ "!DOCTYPE",		CLASS_VOID },
+	{ "editor",		CLASS_LINE },
+	{ "email",		CLASS_ENCL },
+	{ "emphasis",		CLASS_LINE },
+	{ "!ENTITY",		CLASS_VOID },
+	{ "entry",		CLASS_ENCL },
+	{ "envar",		CLASS_LINE },
+	{ "errorname",		CLASS_LINE },
+	{ "fieldsynopsis",	CLASS_TRANS },
+	{ "filename",		CLASS_LINE },
+	{ "firstterm",		CLASS_LINE },
+	{ "footnote",		CLASS_BLOCK },
+	{ "funcdef",		CLASS_BLOCK },
+	{ "funcparams",		CLASS_LINE },
+	{ "funcprototype",	CLASS_BLOCK },
+	{ "funcsynopsis",	CLASS_TRANS },
+	{ "funcsynopsisinfo",	CLASS_LINE },
+	{ "function",		CLASS_LINE },
+	{ "glossterm",		CLASS_LINE },
+	{ "group",		CLASS_ENCL },
+	{ "imagedata",		CLASS_TEXT },
+	{ "xi:include",		CLASS_VOID },
+	{ "index",		CLASS_TRANS },
+	{ "info",		CLASS_TRANS },
+	{ "informalequation",	CLASS_BLOCK },
+	{ "inlineequation",	CLASS_BLOCK },
+	{ "itemizedlist",	CLASS_BLOCK },
+	{ "keysym",		CLASS_LINE },
+	{ "legalnotice",	CLASS_BLOCK },
+	{ "link",		CLASS_ENCL },
+	{ "listitem",		CLASS_TRANS },
+	{ "literal",		CLASS_ENCL },
+	{ "literallayout",	CLASS_NOFILL },
+	{ "manvolnum",		CLASS_TRANS },
+	{ "markup",		CLASS_LINE },
+	{ "member",		CLASS_LINE },
+	{ "mml:math",		CLASS_LINE },
+	{ "mml:mfenced",	CLASS_LINE },
+	{ "mml:mfrac",		CLASS_LINE },
+	{ "mml:mi",		CLASS_LINE },
+	{ "mml:mn",		CLASS_LINE },
+	{ "mml:mo",		CLASS_LINE },
+	{ "mml:mrow",		CLASS_LINE },
+	{ "mml:msub",		CLASS_LINE },
+	{ "mml:msup",		CLASS_LINE },
+	{ "modifier",		CLASS_LINE },
+	{ "note",		CLASS_BLOCK },
+	{ "olink",		CLASS_ENCL },
+	{ "option",		CLASS_LINE },
+	{ "orderedlist",	CLASS_BLOCK },
+	{ "para",		CLASS_BLOCK },
+	{ "paramdef",		CLASS_LINE },
+	{ "parameter",		CLASS_LINE },
+	{ "personname",		CLASS_TRANS },
+	{ "preface",		CLASS_BLOCK },
+	{ "productname",	CLASS_LINE },
+	{ "programlisting",	CLASS_NOFILL },
+	{ "prompt",		CLASS_TRANS },
+	{ "pubdate",		CLASS_TRANS },
+	{ "quote",		CLASS_ENCL },
+	{ "refclass",		CLASS_TRANS },
+	{ "refdescriptor",	CLASS_TRANS },
+	{ "refentry",		CLASS_TRANS },
+	{ "refentryinfo",	CLASS_VOID },
+	{ "refentrytitle",	CLASS_TRANS },
+	{ "refmeta",		CLASS_TRANS },
+	{ "refmetainfo",	CLASS_TRANS },
+	{ "refmiscinfo",	CLASS_TRANS },
+	{ "refname",		CLASS_LINE },
+	{ "refnamediv",		CLASS_BLOCK },
+	{ "refpurpose",		CLASS_LINE },
+	{ "refsynopsisdiv",	CLASS_BLOCK },
+	{ "replaceable",	CLASS_LINE },
+	{ "row",		CLASS_BLOCK },
+	{ "sbr",		CLASS_BLOCK },
+	{ "screen",		CLASS_NOFILL },
+	{ "section",		CLASS_BLOCK },
+	{ "simplelist",		CLASS_TRANS },
+	{ "simplesect",		CLASS_BLOCK },
+	{ "spanspec",		CLASS_TRANS },
+	{ "subscript",		CLASS_TEXT },
+	{ "subtitle",		CLASS_BLOCK },
+	{ "superscript",	CLASS_TEXT },
+	{ "synopsis",		CLASS_NOFILL },
+	{ "systemitem",		CLASS_LINE },
+	{ "table",		CLASS_TRANS },
+	{ "tbody",		CLASS_TRANS },
+	{ "term",		CLASS_LINE },
+	{ "tfoot",		CLASS_TRANS },
+	{ "tgroup",		CLASS_BLOCK },
+	{ "thead",		CLASS_TRANS },
+	{ "tip",		CLASS_BLOCK },
+	{ "title",		CLASS_BLOCK },
+	{ "type",		CLASS_LINE },
+	{ "variablelist",	CLASS_BLOCK },
+	{ "varlistentry",	CLASS_BLOCK },
+	{ "varname",		CLASS_LINE },
+	{ "void",		CLASS_TEXT },
+	{ "warning",		CLASS_BLOCK },
+	{ "wordasword",		CLASS_TRANS },
+	{ "xref",		CLASS_LINE },
+	{ "year",		CLASS_TRANS },
+	{ "[UNKNOWN]",		CLASS_VOID },
+	{ "(t)",		CLASS_TEXT },
+	{ "(e)",		CLASS_TEXT }
+};
+
+static	const char *const attrkeys[ATTRKEY__MAX] = {
+	"choice",
+	"class",
+	"close",
+	"cols",
+	"DEFINITION",
+	"endterm",
+	"entityref",
+	"fileref",
+	"href",
+	"id",
+	"linkend",
+	"localinfo",
+	"NAME",
+	"open",
+	"PUBLIC",
+	"rep",
+	"SYSTEM",
+	"targetdoc",
+	"targetptr",
+	"url",
+	"xlink:href"
+};
+
+static	const char *const attrvals[ATTRVAL__MAX] = {
+	"event",
+	"ipaddress",
+	"monospaced",
+	"norepeat",
+	"opt",
+	"plain",
+	"repeat",
+	"req",
+	"systemname"
+};
+
+/*
+ * Element names not matching any node type,
+ * but mapped to a node type nonetheless.
+ */
+struct	alias {
+	const char	*name;   /* DocBook element name. */
+	enum nodeid	 node;   /* Node type to generate. */
+};
+
+static	const struct alias aliases[] = {
+	{ "acronym",		NODE_IGNORE },
+	{ "affiliation",	NODE_IGNORE },
+	{ "anchor",		NODE_DELETE },
+	{ "application",	NODE_COMMAND },
+	{ "article",		NODE_SECTION },
+	{ "articleinfo",	NODE_BOOKINFO },
+	{ "book",		NODE_SECTION },
+	{ "chapter",		NODE_SECTION },
+	{ "caption",		NODE_IGNORE },
+	{ "code",		NODE_LITERAL },
+	{ "computeroutput",	NODE_LITERAL },
+	{ "!doctype",		NODE_DOCTYPE },
+	{ "figure",		NODE_IGNORE },
+	{ "firstname",		NODE_PERSONNAME },
+	{ "glossary",		NODE_VARIABLELIST },
+	{ "glossdef",		NODE_IGNORE },
+	{ "glossdiv",		NODE_IGNORE },
+	{ "glossentry",		NODE_VARLISTENTRY },
+	{ "glosslist",		NODE_VARIABLELIST },
+	{ "holder",		NODE_IGNORE },
+	{ "imageobject",	NODE_IGNORE },
+	{ "indexterm",		NODE_DELETE },
+	{ "informaltable",	NODE_TABLE },
+	{ "jobtitle",		NODE_IGNORE },
+	{ "keycap",		NODE_KEYSYM },
+	{ "keycode",		NODE_IGNORE },
+	{ "keycombo",		NODE_IGNORE },
+	{ "mediaobject",	NODE_BLOCKQUOTE },
+	{ "orgdiv",		NODE_IGNORE },
+	{ "orgname",		NODE_IGNORE },
+	{ "othercredit",	NODE_AUTHOR },
+	{ "othername",		NODE_PERSONNAME },
+	{ "part",		NODE_SECTION },
+	{ "phrase",		NODE_IGNORE },
+	{ "primary",		NODE_DELETE },
+	{ "property",		NODE_PARAMETER },
+	{ "reference",		NODE_SECTION },
+	{ "refsect1",		NODE_SECTION },
+	{ "refsect2",		NODE_SECTION },
+	{ "refsect3",		NODE_SECTION },
+	{ "refsection",		NODE_SECTION },
+	{ "releaseinfo",	NODE_IGNORE },
+	{ "returnvalue",	NODE_IGNORE },
+	{ "secondary",		NODE_DELETE },
+	{ "sect1",		NODE_SECTION },
+	{ "sect2",		NODE_SECTION },
+	{ "sect3",		NODE_SECTION },
+	{ "sect4",		NODE_SECTION },
+	{ "sgmltag",		NODE_MARKUP },
+	{ "simpara",		NODE_PARA },
+	{ "structfield",	NODE_PARAMETER },
+	{ "structname",		NODE_TYPE },
+	{ "surname",		NODE_PERSONNAME },
+	{ "symbol",		NODE_CONSTANT },
+	{ "tag",		NODE_MARKUP },
+	{ "trademark",		NODE_IGNORE },
+	{ "ulink",		NODE_LINK },
+	{ "userinput",		NODE_LITERAL }
+};
@@ -0,0 +1,83 @@
+/* This file is generated by mkhash from names.h. */
+
+/* Element names, up to NODE_UNKNOWN. */
+static	const unsigned char nodedisp[64] = {
+	  6,   5,   1,   1,   1,   7,   4,   0,   4,   1,   9,   5,
+	  1,   4,   1,  11,   3,   2,   4,   7,   1,  11,   2,   2,
+	 12,   0,   3,   1,  15,   1,   5,   6,   0,   9,   2,  15,
+	  3,   4,   1,   0,  13,   5,   0,   0,  14,  14,   8,  34,
+	 14,   3,  48,   6,  14,  24,   0,   0,   5,   5,   0,  18,
+	 64,   9,   3,  13
+};
+
+static	const unsigned short nodeslot[128] = {
+	  83,   19,   43,   94,   77,   84,   62,    0,   27,   17,
+	   0,   23,    0,   39,   12,    0,   40,   65,   85,   32,
+	  52,   14,  115,   68,   15,   53,   22,   92,   28,   71,
+	   0,   60,   16,   31,   13,    0,  105,  112,   54,   35,
+	 104,  116,    2,   48,   76,   98,   25,   49,    9,   47,
+	 110,   18,  107,   91,   66,   82,  113,  103,    0,    0,
+	  45,  102,   37,   20,   80,   34,   95,   38,   44,   96,
+	  67,   42,  117,   99,   33,  118,    4,  109,   24,    1,
+	  21,   74,   51,    6,   30,  108,   36,   46,   75,   41,
+	 111,   72,   70,   26,   29,  106,   88,    7,    0,   11,
+	  90,   79,  101,   63,  114,   97,   10,   81,   55,   86,
+	 119,   56,   50,   89,   73,    5,   58,   78,    8,   57,
+	   3,   87,   59,   93,   64,   69,   61,  100
+};
+
+static	const struct nametab nodetab = {
+	nodedisp, nodeslot, 6, 7
+};
+
+/* Element aliases. */
+static	const unsigned char aliasdisp[32] = {
+	  4,   1,   1,   0,   1,   1,   1,   3,  17,   0,  15,   1,
+	  1,   3,   6,   2,   0,   2,   0,   1,  20,   8,   1,   2,
+	  0,   1,   1,  12,   6,   3,   1,   4
+};
+
+static	const unsigned short aliasslot[64] = {
+	  33,   49,    9,   25,   10,   57,   19,   39,   36,    4,
+	  29,    0,   26,    0,   28,   15,   42,   16,    6,   58,
+	  30,   52,    0,   21,   11,    3,    0,    0,   31,   41,
+	  22,   44,   47,   53,   18,   27,    7,   56,   48,   14,
+	   2,   20,    0,    1,   17,   46,   45,   43,   51,   54,
+	  37,   50,   24,   34,   40,   12,   35,   23,   32,   38,
+	  13,    5,   55,    8
+};
+
+static	const struct nametab aliastab = {
+	aliasdisp, aliasslot, 5, 6
+};
+
+/* Attribute keys. */
+static	const unsigned char attrkeydisp[16] = {
+	  0,   2,   0,   2,   0,   1,   1,   2,   1,   1,   1,   1,
+	  6,   1,   8,   0
+};
+
+static	const unsigned short attrkeyslot[32] = {
+	  16,    0,   10,    3,    0,    1,    4,    6,    9,    7,
+	  20,    2,    0,   17,   14,    0,    0,    0,   12,   13,
+	   0,    0,    8,    0,   15,   19,   11,    5,   18,    0,
+	   0,   21
+};
+
+static	const struct nametab attrkeytab = {
+	attrkeydisp, attrkeyslot, 4, 5
+};
+
+/* Attribute values. */
+static	const unsigned char attrvaldisp[8] = {
+	  0,   2,   1,   0,   0,   1,   2,   0
+};
+
+static	const unsigned short attrvalslot[16] = {
+	   4,    8,    5,    0,    3,    1,    0,    6,    0,    2,
+	   0,    7,    0,    0,    0,    9
+};
+
+static	const struct nametab attrvaltab = {
+	attrvaldisp, attrvalslot, 3, 4
+};
@@ -16,191 +16,27 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "xmalloc.h"
 #include "node.h"
+#include "phash.h"
+#include "names.h"
+#include "nametab.h"
 
 /*
  * The implementation of the DocBook syntax tree.
  */
 
-struct	nodeprop {
-	const char	*name;
-	enum nodeclass	 class;
-};
-
-static	const struct nodeprop properties[] = {
-	{ "abstract",		CLASS_BLOCK },
-	{ "appendix",		CLASS_BLOCK },
-	{ "arg",		CLASS_ENCL },
-	{ "author",		CLASS_LINE },
-	{ "authorgroup",	CLASS_BLOCK },
-	{ "blockquote",		CLASS_BLOCK },
-	{ "bookinfo",		CLASS_BLOCK },
-	{ "caution",		CLASS_BLOCK },
-	{ "citerefentry",	CLASS_LINE },
-	{ "citetitle",		CLASS_LINE },
-	{ "cmdsynopsis",	CLASS_TRANS },
-	{ "colspec",		CLASS_VOID },
-	{ "command",		CLASS_LINE },
-	{ "constant",		CLASS_LINE },
-	{ "contrib",		CLASS_TRANS },
-	{ "copyright",		CLASS_LINE },
-	{ "date",		CLASS_TRANS },
-	{ "!DOCTYPE",		CLASS_VOID },
-	{ "editor",		CLASS_LINE },
-	{ "email",		CLASS_ENCL },
-	{ "emphasis",		CLASS_LINE },
-	{ "!ENTITY",		CLASS_VOID },
-	{ "entry",		CLASS_ENCL },
-	{ "envar",		CLASS_LINE },
-	{ "errorname",		CLASS_LINE },
-	{ "fieldsynopsis",	CLASS_TRANS },
-	{ "filename",		CLASS_LINE },
-	{ "firstterm",		CLASS_LINE },
-	{ "footnote",		CLASS_BLOCK },
-	{ "funcdef",		CLASS_BLOCK },
-	{ "funcparams",		CLASS_LINE },
-	{ "funcprototype",	CLASS_BLOCK },
-	{ "funcsynopsis",	CLASS_TRANS },
-	{ "funcsynopsisinfo",	CLASS_LINE },
-	{ "function",		CLASS_LINE },
-	{ "glossterm",		CLASS_LINE },
-	{ "group",		CLASS_ENCL },
-	{ "imagedata",		CLASS_TEXT },
-	{ "xi:include",		CLASS_VOID },
-	{ "index",		CLASS_TRANS },
-	{ "info",		CLASS_TRANS },
-	{ "informalequation",	CLASS_BLOCK },
-	{ "inlineequation",	CLASS_BLOCK },
-	{ "itemizedlist",	CLASS_BLOCK },
-	{ "keysym",		CLASS_LINE },
-	{ "legalnotice",	CLASS_BLOCK },
-	{ "link",		CLASS_ENCL },
-	{ "listitem",		CLASS_TRANS },
-	{ "literal",		CLASS_ENCL },
-	{ "literallayout",	CLASS_NOFILL },
-	{ "manvolnum",		CLASS_TRANS },
-	{ "markup",		CLASS_LINE },
-	{ "member",		CLASS_LINE },
-	{ "mml:math",		CLASS_LINE },
-	{ "mml:mfenced",	CLASS_LINE },
-	{ "mml:mfrac",		CLASS_LINE },
-	{ "mml:mi",		CLASS_LINE },
-	{ "mml:mn",		CLASS_LINE },
-	{ "mml:mo",		CLASS_LINE },
-	{ "mml:mrow",		CLASS_LINE },
-	{ "mml:msub",		CLASS_LINE },
-	{ "mml:msup",		CLASS_LINE },
-	{ "modifier",		CLASS_LINE },
-	{ "note",		CLASS_BLOCK },
-	{ "olink",		CLASS_ENCL },
-	{ "option",		CLASS_LINE },
-	{ "orderedlist",	CLASS_BLOCK },
-	{ "para",		CLASS_BLOCK },
-	{ "paramdef",		CLASS_LINE },
-	{ "parameter",		CLASS_LINE },
-	{ "personname",		CLASS_TRANS },
-	{ "preface",		CLASS_BLOCK },
-	{ "productname",	CLASS_LINE },
-	{ "programlisting",	CLASS_NOFILL },
-	{ "prompt",		CLASS_TRANS },
-	{ "pubdate",		CLASS_TRANS },
-	{ "quote",		CLASS_ENCL },
-	{ "refclass",		CLASS_TRANS },
-	{ "refdescriptor",	CLASS_TRANS },
-	{ "refentry",		CLASS_TRANS },
-	{ "refentryinfo",	CLASS_VOID },
-	{ "refentrytitle",	CLASS_TRANS },
-	{ "refmeta",		CLASS_TRANS },
-	{ "refmetainfo",	CLASS_TRANS },
-	{ "refmiscinfo",	CLASS_TRANS },
-	{ "refname",		CLASS_LINE },
-	{ "refnamediv",		CLASS_BLOCK },
-	{ "refpurpose",		CLASS_LINE },
-	{ "refsynopsisdiv",	CLASS_BLOCK },
-	{ "replaceable",	CLASS_LINE },
-	{ "row",		CLASS_BLOCK },
-	{ "sbr",		CLASS_BLOCK },
-	{ "screen",		CLASS_NOFILL },
-	{ "section",		CLASS_BLOCK },
-	{ "simplelist",		CLASS_TRANS },
-	{ "simplesect",		CLASS_BLOCK },
-	{ "spanspec",		CLASS_TRANS },
-	{ "subscript",		CLASS_TEXT },
-	{ "subtitle",		CLASS_BLOCK },
-	{ "superscript",	CLASS_TEXT },
-	{ "synopsis",		CLASS_NOFILL },
-	{ "systemitem",		CLASS_LINE },
-	{ "table",		CLASS_TRANS },
-	{ "tbody",		CLASS_TRANS },
-	{ "term",		CLASS_LINE },
-	{ "tfoot",		CLASS_TRANS },
-	{ "tgroup",		CLASS_BLOCK },
-	{ "thead",		CLASS_TRANS },
-	{ "tip",		CLASS_BLOCK },
-	{ "title",		CLASS_BLOCK },
-	{ "type",		CLASS_LINE },
-	{ "variablelist",	CLASS_BLOCK },
-	{ "varlistentry",	CLASS_BLOCK },
-	{ "varname",		CLASS_LINE },
-	{ "void",		CLASS_TEXT },
-	{ "warning",		CLASS_BLOCK },
-	{ "wordasword",		CLASS_TRANS },
-	{ "xref",		CLASS_LINE },
-	{ "year",		CLASS_TRANS },
-	{ "[UNKNOWN]",		CLASS_VOID },
-	{ "(t)",		CLASS_TEXT },
-	{ "(e)",		CLASS_TEXT }
-};
-
-static	const char *const attrkeys[ATTRKEY__MAX] = {
-	"choice",
-	"class",
-	"close",
-	"cols",
-	"DEFINITION",
-	"endterm",
-	"entityref",
-	"fileref",
-	"href",
-	"id",
-	"linkend",
-	"localinfo",
-	"NAME",
-	"open",
-	"PUBLIC",
-	"rep",
-	"SYSTEM",
-	"targetdoc",
-	"targetptr",
-	"url",
-	"xlink:href"
-};
-
-static	const char *const attrvals[ATTRVAL__MAX] = {
-	"event",
-	"ipaddress",
-	"monospaced",
-	"norepeat",
-	"opt",
-	"plain",
-	"repeat",
-	"req",
-	"systemname"
-};
-
 enum attrkey
 attrkey_parse(const char *name)
 {
-	enum attrkey	 key;
+	int	 i;
 
-	for (key = 0; key < ATTRKEY__MAX; key++)
-		if (strcmp(name, attrkeys[key]) == 0)
-			break;
-	return key;
+	i = name_find(&attrkeytab, name);
+	return i == -1 || strcmp(name, attrkeys[i]) ? ATTRKEY__MAX : i;
 }
 
 const char *
@@ -212,12 +48,10 @@ attrkey_name(enum attrkey key)
 enum attrval
 attrval_parse(const char *name)
 {
-	enum attrval	 val;
+	int	 i;
 
-	for (val = 0; val < ATTRVAL__MAX; val++)
-		if (strcmp(name, attrvals[val]) == 0)
-			break;
-	return val;
+	i = name_find(&attrvaltab, name);
+	return i == -1 || strcmp(name, attrvals[i]) ? ATTRVAL__MAX : i;
 }
 
 const char *
@@ -229,12 +63,24 @@ attr_getval(const struct pattr *a)
 enum nodeid
 pnode_parse(const char *name)
 {
-	enum nodeid	 node;
+	int	 i;
+
+	i = name_find(&nodetab, name);
+	return i == -1 || strcmp(name, properties[i].name) ?
+	    NODE_UNKNOWN : (enum nodeid)i;
+}
+
+/*
+ * Map an element name that is not a node name to a node type.
+ */
+enum nodeid
+pnode_alias(const char *name)
+{
+	int	 i;
 
-	for (node = 0; node < NODE_UNKNOWN; node++)
-		if (strcmp(name, properties[node].name) == 0)
-			break;
-	return node;
+	i = name_find(&aliastab, name);
+	return i == -1 || strcmp(name, aliases[i].name) ?
+	    NODE_UNKNOWN : aliases[i].node;
 }
 
 const char *
@@ -251,76 +97,205 @@ pnode_class(enum nodeid node)
 	return properties[node].class;
 }
 
-struct pnode *
-pnode_alloc(struct pnode *np)
+/*
+ * Allocate a node followed by sz bytes of storage from the arena a,
+ * appending it to np (NULL is ok).
+ * All nodes of a tree are allocated from the same arena,
+ * and their memory is only released together with it.
+ */
+static struct pnode *
+pnode_alloc_size(struct arena *a, struct pnode *np, size_t sz)
 {
 	struct pnode	*n;
 
-	n = xcalloc(1, sizeof(*n));
-	TAILQ_INIT(&n->childq);
-	TAILQ_INIT(&n->attrq);
-	if ((n->parent = np) != NULL)
-		TAILQ_INSERT_TAIL(&np->childq, n, child);
+	n = arena_calloc(a, 1, sizeof(*n) + sz);
+	n->prev = n;
+	if (np != NULL)
+		pnode_insert(np, n, NULL);
 	return n;
 }
 
 struct pnode *
-pnode_alloc_text(struct pnode *np, const char *text)
+pnode_alloc(struct arena *a, struct pnode *np)
+{
+	return pnode_alloc_size(a, np, 0);
+}
+
+/*
+ * Allocate a text node, storing the text directly behind the node.
+ */
+struct pnode *
+pnode_alloc_text(struct arena *a, struct pnode *np, const char *text)
 {
 	struct pnode	*n;
+	size_t		 sz;
 
-	n = pnode_alloc(np);
-	n->node = NODE_TEXT;
-	n->b = xstrdup(text);
+	sz = strlen(text) + 1;
+	n = pnode_alloc_size(a, np, sz);
+	pnode_settype(n, NODE_TEXT);
+	n->u.b = memcpy(n + 1, text, sz);
 	return n;
 }
 
 /*
- * Recursively free a node (NULL is ok).
+ * Recursively copy the node n into the arena a,
+ * appending the copy to np (NULL is ok).
  */
-static void
-pnode_free(struct pnode *n)
+struct pnode *
+pnode_clone(struct arena *a, struct pnode *np, struct pnode *n)
 {
-	struct pnode	*nc;
-	struct pattr	*a;
+	struct pnode	*nn, *nc;
+	struct pattr	*at, *na;
+	size_t		 sz;
+
+	sz = PNODE_ISTEXT(n) && n->u.b != NULL ? strlen(n->u.b) + 1 : 0;
+	nn = pnode_alloc_size(a, np, sz);
+	nn->node = n->node;
+	nn->class = n->class;
+	nn->flags = n->flags;
+	if (sz > 0)
+		nn->u.b = memcpy(nn + 1, n->u.b, sz);
+	else if (PNODE_ISTEXT(n) == 0 && n->u.attr != NULL) {
+		for (sz = 1; sz < n->u.attr->num; sz *= 2)
+			continue;
+		nn->u.attr = arena_calloc(a, 1,
+		    sizeof(*nn->u.attr) + sz * sizeof(*na));
+		nn->u.attr->mask = n->u.attr->mask;
+		nn->u.attr->num = n->u.attr->num;
+		na = nn->u.attr->a;
+		PATTR_FOREACH(at, n) {
+			na->key = at->key;
+			na->val = at->val;
+			if (at->rawval != NULL)
+				na->rawval = arena_strdup(a, at->rawval);
+			na++;
+		}
+	}
+	PNODE_FOREACH(nc, n)
+		pnode_clone(a, nn, nc);
+	return nn;
+}
 
-	if (n == NULL)
-		return;
+/*
+ * Set the node type and cache its class.
+ * Nodes with a string value must not become elements or vice versa.
+ */
+void
+pnode_settype(struct pnode *n, enum nodeid node)
+{
+	assert(n->u.b == NULL || PNODE_ISTEXT(n) ==
+	    (node == NODE_TEXT || node == NODE_ESCAPE));
+	n->node = node;
+	n->class = pnode_class(node);
+}
 
-	while ((nc = TAILQ_FIRST(&n->childq)) != NULL) {
-		TAILQ_REMOVE(&n->childq, nc, child);
-		pnode_free(nc);
-	}
-	while ((a = TAILQ_FIRST(&n->attrq)) != NULL) {
-		TAILQ_REMOVE(&n->attrq, a, child);
-		free(a->rawval);
-		free(a);
+/*
+ * Insert the unlinked node n into the children of np,
+ * before the child next, or at the end if next is NULL.
+ */
+void
+pnode_insert(struct pnode *np, struct pnode *n, struct pnode *next)
+{
+	n->parent = np;
+	n->next = next;
+	if (next == NULL) {
+		if (np->child == NULL) {
+			np->child = n;
+			n->prev = n;
+		} else {
+			n->prev = np->child->prev;
+			n->prev->next = n;
+			np->child->prev = n;
+		}
+	} else {
+		n->prev = next->prev;
+		next->prev = n;
+		if (np->child == next)
+			np->child = n;
+		else
+			n->prev->next = n;
 	}
-	free(n->b);
-	free(n);
 }
 
 /*
- * Unlink a node from its parent and pnode_free() it.
+ * Unlink a node from its parent (NULL is ok).
+ * Its memory is released together with the arena.
  */
 void
 pnode_unlink(struct pnode *n)
 {
-	if (n == NULL)
+	struct pnode	*np;
+
+	if (n == NULL || (np = n->parent) == NULL)
 		return;
-	if (n->parent != NULL)
-		TAILQ_REMOVE(&n->parent->childq, n, child);
-	pnode_free(n);
+	if (n->next != NULL)
+		n->next->prev = n->prev;
+	else
+		np->child->prev = n->prev;
+	if (np->child == n)
+		np->child = n->next;
+	else
+		n->prev->next = n->next;
+	n->parent = n->next = NULL;
+	n->prev = n;
 }
 
 /*
- * Unlink all children of a node and pnode_free() them.
+ * Unlink all children of a node.
  */
 void
 pnode_unlinksub(struct pnode *n)
 {
-	while (TAILQ_EMPTY(&n->childq) == 0)
-		pnode_unlink(TAILQ_FIRST(&n->childq));
+	n->child = NULL;
+}
+
+/*
+ * Append an attribute with the given key and without a value
+ * to the node n, allocating from the arena a.
+ * The slots are kept in one array growing geometrically.
+ * Return NULL if the node already has an attribute with that key.
+ */
+struct pattr *
+pnode_addattr(struct arena *a, struct pnode *n, enum attrkey key)
+{
+	struct pattrs	*as;
+	struct pattr	*at;
+	unsigned int	 num;
+
+	assert(key < ATTRKEY__MAX);
+	assert(PNODE_ISTEXT(n) == 0);
+	if ((as = n->u.attr) != NULL && as->mask & 1U << key)
+		return NULL;
+	num = as == NULL ? 0 : as->num;
+	if ((num & (num - 1)) == 0) {
+		as = arena_calloc(a, 1, sizeof(*as) +
+		    (num == 0 ? 1 : num * 2) * sizeof(*at));
+		if (num > 0)
+			memcpy(as, n->u.attr, sizeof(*as) + num * sizeof(*at));
+		n->u.attr = as;
+	}
+	at = as->a + as->num++;
+	at->key = key;
+	at->val = ATTRVAL__MAX;
+	as->mask |= 1U << key;
+	return at;
+}
+
+/*
+ * Find the attribute with the given key.
+ * The mask answers for absent keys without looking at the slots.
+ */
+static struct pattr *
+pnode_findattr(struct pnode *n, enum attrkey key)
+{
+	struct pattr	*a;
+
+	if (n == NULL || PNODE_ISTEXT(n) || n->u.attr == NULL ||
+	    (n->u.attr->mask & 1U << key) == 0)
+		return NULL;
+	for (a = n->u.attr->a; a->key != key; a++)
+		continue;
+	return a;
 }
 
 /*
@@ -332,12 +307,7 @@ pnode_getattr(struct pnode *n, enum attrkey key)
 {
 	struct pattr	*a;
 
-	if (n == NULL)
-		return ATTRVAL__MAX;
-	TAILQ_FOREACH(a, &n->attrq, child)
-		if (a->key == key)
-			return a->val;
-	return ATTRVAL__MAX;
+	return (a = pnode_findattr(n, key)) == NULL ? ATTRVAL__MAX : a->val;
 }
 
 /*
@@ -349,13 +319,10 @@ pnode_getattr_raw(struct pnode *n, enum attrkey key, const char *defval)
 {
 	struct pattr	*a;
 
-	if (n == NULL)
+	if ((a = pnode_findattr(n, key)) == NULL)
 		return defval;
-	TAILQ_FOREACH(a, &n->attrq, child)
-		if (a->key == key)
-			return a->val != ATTRVAL__MAX ? attrvals[a->val] :
-			    a->rawval != NULL ? a->rawval : defval;
-	return defval;
+	return a->val != ATTRVAL__MAX ? attrvals[a->val] :
+	    a->rawval != NULL ? a->rawval : defval;
 }
 
 /*
@@ -370,7 +337,7 @@ pnode_findfirst(struct pnode *n, enum nodeid node)
 		return NULL;
 	if (n->node == node)
 		return n;
-	TAILQ_FOREACH(nc, &n->childq, child)
+	PNODE_FOREACH(nc, n)
 		if ((res = pnode_findfirst(nc, node)) != NULL)
 			return res;
 	return NULL;
@@ -384,7 +351,162 @@ pnode_takefirst(struct pnode *n, enum nodeid node)
 {
 	struct pnode	*nc;
 
-	if ((nc = pnode_findfirst(n, node)) != NULL && nc->parent != NULL)
-		TAILQ_REMOVE(&nc->parent->childq, nc, child);
+	if ((nc = pnode_findfirst(n, node)) != NULL)
+		pnode_unlink(nc);
+	return nc;
+}
+
+/*
+ * Count the subtree n in the node type index of the tree t.
+ * If the subtree is not at the end of the document, it may
+ * precede the first nodes recorded so far, so forget them.
+ */
+static void
+ptree_count(struct ptree *t, struct pnode *n, int atend)
+{
+	struct pnode	*nc;
+
+	if (t->count[n->node]++ == 0)
+		t->first[n->node] = n;
+	else if (atend == 0)
+		t->first[n->node] = NULL;
+	PNODE_FOREACH(nc, n)
+		ptree_count(t, nc, atend);
+}
+
+/*
+ * Remove the subtree n from the node type index of the tree t.
+ */
+static void
+ptree_uncount(struct ptree *t, struct pnode *n)
+{
+	struct pnode	*nc;
+
+	assert(t->count[n->node] > 0);
+	t->count[n->node]--;
+	if (t->first[n->node] == n)
+		t->first[n->node] = NULL;
+	PNODE_FOREACH(nc, n)
+		ptree_uncount(t, nc);
+}
+
+/*
+ * Record the subtree n, which was just added
+ * at the end of the document, in the node type index.
+ */
+void
+ptree_append(struct ptree *t, struct pnode *n)
+{
+	ptree_count(t, n, 1);
+}
+
+/*
+ * Like pnode_insert(), but also update the node type index.
+ */
+void
+ptree_insert(struct ptree *t, struct pnode *np, struct pnode *n,
+    struct pnode *next)
+{
+	pnode_insert(np, n, next);
+	ptree_count(t, n, 0);
+}
+
+/*
+ * Like pnode_unlink(), but also update the node type index.
+ * The document element cannot be unlinked, but other subtrees
+ * without a parent, like the doctype, are dropped from the index.
+ */
+void
+ptree_unlink(struct ptree *t, struct pnode *n)
+{
+	if (n == NULL || n == t->root)
+		return;
+	pnode_unlink(n);
+	ptree_uncount(t, n);
+}
+
+#ifdef DEBUG
+static void
+ptree_recount(struct pnode *n, unsigned int *count)
+{
+	struct pnode	*nc;
+
+	count[n->node]++;
+	PNODE_FOREACH(nc, n)
+		ptree_recount(nc, count);
+}
+#endif
+
+/*
+ * In a DEBUG build, verify that the node type index of the tree t
+ * counts exactly the nodes below the document element.
+ */
+void
+ptree_check(struct ptree *t)
+{
+#ifdef DEBUG
+	unsigned int	 count[NODE_IGNORE];
+	enum nodeid	 node;
+
+	memset(count, 0, sizeof(count));
+	if (t->root != NULL)
+		ptree_recount(t->root, count);
+	for (node = 0; node < NODE_IGNORE; node++) {
+		assert(t->count[node] == count[node]);
+		assert(t->first[node] == NULL ||
+		    t->first[node] == pnode_findfirst(t->root, node));
+	}
+#endif
+}
+
+/*
+ * Change the type of the node n, which is part of the tree t.
+ */
+void
+ptree_settype(struct ptree *t, struct pnode *n, enum nodeid node)
+{
+	assert(t->count[n->node] > 0);
+	t->count[n->node]--;
+	if (t->first[n->node] == n)
+		t->first[n->node] = NULL;
+	pnode_settype(n, node);
+	if (t->count[node]++ == 0)
+		t->first[node] = n;
+	else
+		t->first[node] = NULL;
+}
+
+/*
+ * Like pnode_findfirst(), but using the node type index of the tree t,
+ * which n has to be part of.  If the tree contains no such node,
+ * or if the first one is below n, no searching is needed at all.
+ */
+struct pnode *
+ptree_findfirst(struct ptree *t, struct pnode *n, enum nodeid node)
+{
+	struct pnode	*nf, *np;
+
+	if (n == NULL || t->count[node] == 0)
+		return NULL;
+	if ((nf = t->first[node]) == NULL &&
+	    (nf = t->first[node] = pnode_findfirst(t->root, node)) == NULL)
+		return NULL;
+	for (np = nf; np != NULL; np = np->parent)
+		if (np == n)
+			return nf;
+	return pnode_findfirst(n, node);
+}
+
+/*
+ * Like pnode_takefirst(), but using and updating
+ * the node type index of the tree t.
+ */
+struct pnode *
+ptree_takefirst(struct ptree *t, struct pnode *n, enum nodeid node)
+{
+	struct pnode	*nc;
+
+	if ((nc = ptree_findfirst(t, n, node)) != NULL)
+		ptree_unlink(t, nc);
 	return nc;
 }
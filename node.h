@@ -15,12 +15,12 @@
  * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
-#include <bsdqueue.h>
-
 /*
  * The interface of the DocBook syntax tree.
  */
 
+struct arena;	 /* Opaque object; used only in xmalloc.c. */
+
 /*
  * How the output from each node behaves
  * with respect to mdoc(7) structure.
@@ -215,43 +215,88 @@ enum	attrval {
 	ATTRVAL__MAX
 };
 
-TAILQ_HEAD(pnodeq, pnode);
-TAILQ_HEAD(pattrq, pattr);
-
 /*
  * One DocBook XML element attribute.
  */
 struct	pattr {
+	char		*rawval;
 	enum attrkey	 key;
 	enum attrval	 val;
-	char		*rawval;
-	TAILQ_ENTRY(pattr) child;
+};
+
+/*
+ * The attributes of one element.
+ */
+struct	pattrs {
+	unsigned int	 mask;     /* Keys present, 1 << key. */
+	unsigned int	 num;      /* Number of attributes. */
+	struct pattr	 a[];      /* Attributes in input order. */
 };
 
 /*
  * One DocBook XML element.
+ * The children form a list linked through next and prev,
+ * where prev of the first child points to the last child,
+ * such that appending and finding the last child take constant time.
+ * Only NODE_TEXT and NODE_ESCAPE nodes have a string value,
+ * and only the other nodes have attributes, so they share storage.
  */
 struct	pnode {
-	enum nodeid	 node;     /* Node type. */
-	char		*b;        /* String value. */
 	struct pnode	*parent;   /* Parent node or NULL. */
-	int		 flags;
+	struct pnode	*child;    /* First child or NULL. */
+	struct pnode	*next;     /* Next sibling or NULL. */
+	struct pnode	*prev;     /* Previous sibling or last sibling. */
+	union {
+		char		*b;        /* String value. */
+		struct pattrs	*attr;     /* Attributes or NULL. */
+	} u;
+	unsigned char	 node;     /* enum nodeid; set with pnode_settype(). */
+	unsigned char	 class;    /* Cached enum nodeclass of the type. */
+	unsigned char	 flags;
 #define	NFLAG_LINE	 (1 << 0)  /* New line before this node. */
 #define	NFLAG_SPC	 (1 << 1)  /* Whitespace before this node. */
-	struct pnodeq	 childq;   /* Queue of children. */
-	struct pattrq	 attrq;    /* Attributes of the node. */
-	TAILQ_ENTRY(pnode) child;
 };
 
+#define	PNODE_ISTEXT(n)	((n)->node == NODE_TEXT || (n)->node == NODE_ESCAPE)
+
+/*
+ * Traversal of the children of a node, in the style of <sys/queue.h>.
+ */
+#define	PNODE_FIRST(n)		((n)->child)
+#define	PNODE_LAST(n)		((n)->child == NULL ? NULL : (n)->child->prev)
+#define	PNODE_NEXT(n)		((n)->next)
+#define	PNODE_PREV(n)		((n)->prev->next == NULL ? NULL : (n)->prev)
+#define	PNODE_EMPTY(n)		((n)->child == NULL)
+
+#define	PNODE_FOREACH(var, n)						\
+	for ((var) = (n)->child; (var) != NULL; (var) = (var)->next)
+
+#define	PNODE_FOREACH_SAFE(var, n, tvar)				\
+	for ((var) = (n)->child;					\
+	    (var) != NULL && ((tvar) = (var)->next, 1);			\
+	    (var) = (tvar))
+
+#define	PATTR_FOREACH(var, n)						\
+	for ((var) = PNODE_ISTEXT(n) || (n)->u.attr == NULL ?		\
+	    NULL : (n)->u.attr->a;					\
+	    (var) != NULL && (var) < (n)->u.attr->a + (n)->u.attr->num;	\
+	    (var)++)
+
 /*
  * The parse result for one complete DocBook XML document.
+ * The parser and ptree_reorg() maintain an index of the node types
+ * in the tree; the formatters change the tree without updating it.
  */
 struct	ptree {
 	struct pnode	*root;     /* The document element. */
+	struct arena	*arena;    /* Storage for nodes and strings. */
+	struct pnode	*first[NODE_IGNORE]; /* First node or NULL. */
+	unsigned int	 count[NODE_IGNORE]; /* Number of nodes. */
 	int		 flags;
 #define	TREE_ERROR	 (1 << 0)  /* A parse error occurred. */
 #define	TREE_WARN	 (1 << 1)  /* A parser warning occurred. */
 #define	TREE_CLOSED	 (1 << 3)  /* The document element was closed. */
+#define	TREE_NOTITLE	 (1 << 4)  /* The document has no title. */
 };
 
 
@@ -260,14 +305,29 @@ const char	*attrkey_name(enum attrkey);
 enum attrval	 attrval_parse(const char *);
 const char	*attr_getval(const struct pattr *a);
 enum nodeid	 pnode_parse(const char *name);
+enum nodeid	 pnode_alias(const char *name);
 const char	*pnode_name(enum nodeid);
 enum nodeclass	 pnode_class(enum nodeid);
 
-struct pnode	*pnode_alloc(struct pnode *);
-struct pnode	*pnode_alloc_text(struct pnode *, const char *);
+struct pnode	*pnode_alloc(struct arena *, struct pnode *);
+struct pnode	*pnode_alloc_text(struct arena *, struct pnode *,
+			const char *);
+struct pnode	*pnode_clone(struct arena *, struct pnode *, struct pnode *);
+void		 pnode_settype(struct pnode *, enum nodeid);
+void		 pnode_insert(struct pnode *, struct pnode *, struct pnode *);
 void		 pnode_unlink(struct pnode *);
 void		 pnode_unlinksub(struct pnode *);
+struct pattr	*pnode_addattr(struct arena *, struct pnode *, enum attrkey);
 enum attrval	 pnode_getattr(struct pnode *, enum attrkey);
 const char	*pnode_getattr_raw(struct pnode *, enum attrkey, const char *);
 struct pnode	*pnode_findfirst(struct pnode *, enum nodeid);
 struct pnode	*pnode_takefirst(struct pnode *, enum nodeid);
+
+void		 ptree_append(struct ptree *, struct pnode *);
+void		 ptree_insert(struct ptree *, struct pnode *, struct pnode *,
+			struct pnode *);
+void		 ptree_unlink(struct ptree *, struct pnode *);
+void		 ptree_check(struct ptree *);
+void		 ptree_settype(struct ptree *, struct pnode *, enum nodeid);
+struct pnode	*ptree_findfirst(struct ptree *, struct pnode *, enum nodeid);
+struct pnode	*ptree_takefirst(struct ptree *, struct pnode *, enum nodeid);
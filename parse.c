@@ -16,6 +16,8 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 #include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <assert.h>
 #include <ctype.h>
@@ -23,14 +25,22 @@
 #include <fcntl.h>
 #include <libgen.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "xmalloc.h"
 #include "node.h"
 #include "parse.h"
+#include "snap.h"
+#include "phash.h"
+#include "entities.h"
+#include "enttab.h"
 
 /*
  * The implementation of the DocBook parser.
@@ -41,9 +51,134 @@ enum	pstate {
 	PARSE_TAG,
 	PARSE_ARG,
 	PARSE_SQ,
-	PARSE_DQ
+	PARSE_DQ,
+	PARSE_COMMENT,	/* Inside <!-- -->. */
+	PARSE_PI,	/* Inside <? ?>. */
+	PARSE_DECL,	/* Inside another <! > declaration. */
+	PARSE_DECLSQ,	/* Single-quoted string in a declaration. */
+	PARSE_DECLDQ	/* Double-quoted string in a declaration. */
 };
 
+/*
+ * A file read while parsing a cached fragment,
+ * and its identity at the time it was read.
+ */
+struct	ffile {
+	char		*path;   /* Relative to the cwd. */
+	dev_t		 dev;
+	ino_t		 ino;
+	off_t		 size;
+	struct timespec	 mtime;
+};
+
+/*
+ * The parse tree generated for an included file,
+ * for reuse at other places including the same file
+ * in the same context.
+ */
+struct	frag {
+	struct frag	*next;    /* Next cached fragment. */
+	struct ffile	*files;   /* The included file and its includes. */
+	size_t		 filesz;  /* Number of elements in files. */
+	size_t		 filemax; /* Allocated size of files. */
+	struct arena	*arena;   /* Storage for the nodes. */
+	struct pnode	*nodes;   /* Container for the generated nodes. */
+	enum nodeid	 ncur;    /* Value of p->ncur after the fragment. */
+	int		 ctx;     /* Context of the include, FCTX_*. */
+#define	FCTX_LINE	 (1 << 0)  /* New line before the include. */
+#define	FCTX_SPC	 (1 << 1)  /* Whitespace before the include. */
+#define	FCTX_NOFILL	 (1 << 2)  /* Inside a no-fill display. */
+#define	FCTX_PREV	 (1 << 3)  /* The parent has other children. */
+#define	FCTX_JOIN	 (1 << 4)  /* Following text is joined, see */
+				   /* pnode_joins(). */
+#define	FCTX_ENTITY	 (1 << 5)  /* Expansion of an internal entity. */
+	int		 endtext; /* The last node is an open text node. */
+};
+
+/*
+ * The parser state when starting to record a fragment.
+ */
+struct	fragstate {
+	struct pnode	*cur;       /* Parent of the included nodes. */
+	struct pnode	*last;      /* Last child of cur before or NULL. */
+	struct pnode	*doctype;
+	struct frag	*rec;       /* Fragment recorded before or NULL. */
+	int		 taint;
+	int		 nref;
+	int		 nofill;
+	int		 treeflags;
+};
+
+/*
+ * Fragments parsed earlier and snapshots of entity files;
+ * shared by parsers in the same process.
+ */
+struct	pcache {
+	struct frag	*frags;
+	struct snap	*snaps;
+	char		*dir;     /* Directory for snapshots or NULL. */
+};
+
+/*
+ * A declaration of a parameter entity including an entity file
+ * whose declarations are taken from a snapshot.
+ */
+struct	snapuse {
+	struct pnode	*decl;   /* Child of the doctype. */
+	struct snap	*snap;   /* Owned by the pcache. */
+	size_t		 seq;    /* Entities declared before. */
+};
+
+enum	enttype {
+	ENT_TEXT,	/* The value is the replacement text. */
+	ENT_SYSTEM	/* The value is a system identifier. */
+};
+
+/*
+ * An entry in the entity hash table of a parser:
+ * the first declaration of a name in the doctype that has a value.
+ */
+struct	entdecl {
+	struct entdecl	*next;   /* Next entry in the same bucket. */
+	const char	*name;   /* Owned by the doctype. */
+	const char	*value;  /* Owned by the doctype. */
+	enum enttype	 type;
+	size_t		 seq;    /* Entities declared before. */
+	struct frag	*frags;  /* Parsed expansions of ENT_TEXT. */
+};
+
+#define	ENT_NBUCKETS	 64	   /* Initial size of the hash table. */
+
+#define	PARSE_BUFSZ	 65536	   /* Initial size of the read buffer. */
+
+/*
+ * The position of the current token in the input file, for messages.
+ * While parsing a buffer, only a pointer to the token is recorded.
+ * Line and column numbers are counted when a message needs them,
+ * continuing from the position counted for the previous message.
+ */
+struct	ppos {
+	const char	*tok;    /* Start of the current token or NULL. */
+	const char	*mark;   /* Counted up to here, if tok is set. */
+	int		 line;   /* Line number at mark, or of the token. */
+	int		 col;    /* Column number at mark, or of the token. */
+};
+
+/*
+ * An input file mapped into memory.  Text nodes and attribute values
+ * may point into it, so it stays mapped until the parser is freed.
+ */
+struct	pmap {
+	struct pmap	*next;
+	char		*b;
+	size_t		 sz;     /* Mapped size, including the NUL byte. */
+};
+
+/* Flags for parse_string(). */
+#define	PSTR_TRACK	 (1 << 0)  /* Record the position of tokens. */
+#define	PSTR_REFILL	 (1 << 1)  /* More input may follow. */
+#define	PSTR_KEEP	 (1 << 2)  /* The buffer outlives the tree. */
+
 /*
  * Global parse state.
  * Keep this as simple and small as possible.
@@ -51,13 +186,33 @@ enum	pstate {
 struct	parse {
 	const char	*fname;  /* Name of the input file. */
 	struct ptree	*tree;   /* Complete parse result. */
+	int		 dirfd;  /* Directory of the input file. */
+	char		*dname;  /* Path to dirfd or NULL for the cwd. */
+	pmsg_func	*msgfunc; /* Message callback or NULL. */
+	void		*msgarg; /* First argument for msgfunc. */
+	pfile_func	*filefunc; /* Callback for opened files or NULL. */
+	void		*filearg; /* First argument for filefunc. */
+	struct pcache	*cache;  /* Cache of included files or NULL. */
+	struct pmap	*maps;   /* Input files mapped so far. */
+	struct frag	*rec;    /* Fragment being recorded or NULL. */
+	int		 taint;  /* Number of context-dependent events. */
+	int		 nref;   /* Number of declared entities referenced. */
+	struct snapuse	*snaps;  /* Entity files taken from snapshots. */
+	size_t		 snapsz; /* Number of elements in snaps. */
+	size_t		 snapmax; /* Allocated size of snaps. */
+	int		 entrec; /* Recording a snapshot. */
+	struct entdecl	**ents;  /* Hash table of entities or NULL. */
+	size_t		 entnb;  /* Number of buckets in ents. */
+	size_t		 entsz;  /* Number of entries in ents. */
 	struct pnode	*doctype;
 	struct pnode	*cur;	 /* Current node in the tree. */
 	enum nodeid	 ncur;   /* Type of the current node. */
-	int		 line;   /* Line number in the input file. */
-	int		 col;	 /* Column number in the input file. */
-	int		 nline;  /* Line number of next token. */
-	int		 ncol;   /* Column number of next token. */
+	size_t		 tlen;   /* Length of the open text node. */
+	size_t		 tsz;    /* Allocated size of the open text node. */
+	char		*tend;   /* Byte after text pointing into the */
+				 /* input, to be overwritten with NUL. */
+	struct ppos	 pos;    /* Position in the input file. */
+	size_t		 resume; /* Bytes of an incomplete token scanned. */
 	int		 del;    /* Levels of nested nodes being deleted. */
 	int		 nofill; /* Levels of open no-fill displays. */
 	int		 flags;
@@ -66,147 +221,101 @@ struct	parse {
 #define	PFLAG_SPC	 (1 << 2)  /* Whitespace before the next element. */
 #define	PFLAG_ATTR	 (1 << 3)  /* The most recent attribute is valid. */
 #define	PFLAG_EEND	 (1 << 4)  /* This element is self-closing. */
+#define	PFLAG_KEEP	 (1 << 5)  /* Nodes may point into the input. */
+#define	PFLAG_ARENA	 (1 << 6)  /* The tree arena belongs to the parser. */
 };
 
-struct	alias {
-	const char	*name;   /* DocBook element name. */
-	enum nodeid	 node;   /* Node type to generate. */
-};
+static size_t	 parse_string(struct parse *, char *, size_t,
+			 enum pstate *, int);
+static void	 parse_fd(struct parse *, int);
+static void	 parse_entfile(struct parse *, struct pnode *,
+			const char *);
+static void	 frag_free(struct frag *);
+static int	 frag_context(struct parse *);
+static void	 frag_use(struct parse *, struct frag *);
+static struct frag *frag_start(struct parse *, int, struct fragstate *);
+static void	 frag_finish(struct parse *, struct frag *,
+			const struct fragstate *, struct frag **);
+static void	 snap_release(struct parse *);
 
-static	const struct alias aliases[] = {
-	{ "acronym",		NODE_IGNORE },
-	{ "affiliation",	NODE_IGNORE },
-	{ "anchor",		NODE_DELETE },
-	{ "application",	NODE_COMMAND },
-	{ "article",		NODE_SECTION },
-	{ "articleinfo",	NODE_BOOKINFO },
-	{ "book",		NODE_SECTION },
-	{ "chapter",		NODE_SECTION },
-	{ "caption",		NODE_IGNORE },
-	{ "code",		NODE_LITERAL },
-	{ "computeroutput",	NODE_LITERAL },
-	{ "!doctype",		NODE_DOCTYPE },
-	{ "figure",		NODE_IGNORE },
-	{ "firstname",		NODE_PERSONNAME },
-	{ "glossary",		NODE_VARIABLELIST },
-	{ "glossdef",		NODE_IGNORE },
-	{ "glossdiv",		NODE_IGNORE },
-	{ "glossentry",		NODE_VARLISTENTRY },
-	{ "glosslist",		NODE_VARIABLELIST },
-	{ "holder",		NODE_IGNORE },
-	{ "imageobject",	NODE_IGNORE },
-	{ "indexterm",		NODE_DELETE },
-	{ "informaltable",	NODE_TABLE },
-	{ "jobtitle",		NODE_IGNORE },
-	{ "keycap",		NODE_KEYSYM },
-	{ "keycode",		NODE_IGNORE },
-	{ "keycombo",		NODE_IGNORE },
-	{ "mediaobject",	NODE_BLOCKQUOTE },
-	{ "orgdiv",		NODE_IGNORE },
-	{ "orgname",		NODE_IGNORE },
-	{ "othercredit",	NODE_AUTHOR },
-	{ "othername",		NODE_PERSONNAME },
-	{ "part",		NODE_SECTION },
-	{ "phrase",		NODE_IGNORE },
-	{ "primary",		NODE_DELETE },
-	{ "property",		NODE_PARAMETER },
-	{ "reference",		NODE_SECTION },
-	{ "refsect1",		NODE_SECTION },
-	{ "refsect2",		NODE_SECTION },
-	{ "refsect3",		NODE_SECTION },
-	{ "refsection",		NODE_SECTION },
-	{ "releaseinfo",	NODE_IGNORE },
-	{ "returnvalue",	NODE_IGNORE },
-	{ "secondary",		NODE_DELETE },
-	{ "sect1",		NODE_SECTION },
-	{ "sect2",		NODE_SECTION },
-	{ "sect3",		NODE_SECTION },
-	{ "sect4",		NODE_SECTION },
-	{ "sgmltag",		NODE_MARKUP },
-	{ "simpara",		NODE_PARA },
-	{ "structfield",	NODE_PARAMETER },
-	{ "structname",		NODE_TYPE },
-	{ "surname",		NODE_PERSONNAME },
-	{ "symbol",		NODE_CONSTANT },
-	{ "tag",		NODE_MARKUP },
-	{ "trademark",		NODE_IGNORE },
-	{ "ulink",		NODE_LINK },
-	{ "userinput",		NODE_LITERAL },
-	{ NULL,			NODE_IGNORE }
-};
 
-struct	entity {
-	const char	*name;
-	const char	*roff;
-};
+/*
+ * Count lines and columns from the mark up to cp.
+ */
+static void
+ppos_count(struct ppos *pos, const char *cp)
+{
+	const char	*nl;
+
+	while ((nl = memchr(pos->mark, '\n', cp - pos->mark)) != NULL) {
+		pos->line++;
+		pos->col = 1;
+		pos->mark = nl + 1;
+	}
+	pos->col += cp - pos->mark;
+	pos->mark = cp;
+}
 
 /*
- * XML character entity references found in the wild.
- * Those that don't have an exact mandoc_char(7) representation
- * are approximated, and the desired codepoint is given as a comment.
- * Encoding them as \\[u...] would leave -Tascii out in the cold.
+ * Start parsing a file from buffer b.
  */
-static	const struct entity entities[] = {
-	{ "alpha",	"\\(*a" },
-	{ "amp",	"&" },
-	{ "apos",	"'" },
-	{ "auml",	"\\(:a" },
-	{ "beta",	"\\(*b" },
-	{ "circ",	"^" },      /* U+02C6 */
-	{ "copy",	"\\(co" },
-	{ "dagger",	"\\(dg" },
-	{ "Delta",	"\\(*D" },
-	{ "eacute",	"\\('e" },
-	{ "emsp",	"\\ " },    /* U+2003 */
-	{ "gt",		">" },
-	{ "hairsp",	"\\^" },
-	{ "kappa",	"\\(*k" },
-	{ "larr",	"\\(<-" },
-	{ "ldquo",	"\\(lq" },
-	{ "le",		"\\(<=" },
-	{ "lowbar",	"_" },
-	{ "lsqb",	"[" },
-	{ "lt",		"<" },
-	{ "mdash",	"\\(em" },
-	{ "minus",	"\\-" },
-	{ "ndash",	"\\(en" },
-	{ "nbsp",	"\\ " },
-	{ "num",	"#" },
-	{ "oslash",	"\\(/o" },
-	{ "ouml",	"\\(:o" },
-	{ "percnt",	"%" },
-	{ "quot",	"\\(dq" },
-	{ "rarr",	"\\(->" },
-	{ "rArr",	"\\(rA" },
-	{ "rdquo",	"\\(rq" },
-	{ "reg",	"\\(rg" },
-	{ "rho",	"\\(*r" },
-	{ "rsqb",	"]" },
-	{ "sigma",	"\\(*s" },
-	{ "shy",	"\\&" },     /* U+00AD */
-	{ "tau",	"\\(*t" },
-	{ "tilde",	"\\[u02DC]" },
-	{ "times",	"\\[tmu]" },
-	{ "uuml",	"\\(:u" },
-	{ NULL,		NULL }
-};
+static void
+ppos_start(struct ppos *pos, const char *b)
+{
+	pos->tok = pos->mark = b;
+	pos->line = 1;
+	pos->col = 1;
+}
 
-static size_t	 parse_string(struct parse *, char *, size_t,
-			 enum pstate *, int);
-static void	 parse_fd(struct parse *, int);
+/*
+ * The buffer goes away or changes; count up to the current token.
+ */
+static void
+ppos_stop(struct ppos *pos)
+{
+	if (pos->tok != NULL) {
+		ppos_count(pos, pos->tok);
+		pos->tok = NULL;
+	}
+}
 
+/*
+ * Print a message, or pass it to the message callback, if any.
+ */
+static void
+parse_msg(struct parse *p, int level, const char *fmt, va_list ap)
+{
+	char		*text;
+
+	if (p->pos.tok != NULL)
+		ppos_count(&p->pos, p->pos.tok);
+	if (p->msgfunc == NULL) {
+		fprintf(stderr, "%s:%d:%d: %s: ", p->fname,
+		    p->pos.line, p->pos.col,
+		    level == MSG_ERROR ? "ERROR" : "WARNING");
+		vfprintf(stderr, fmt, ap);
+		fputc('\n', stderr);
+		return;
+	}
+	if (vasprintf(&text, fmt, ap) == -1) {
+		perror(NULL);
+		exit(6);
+	}
+	(*p->msgfunc)(p->msgarg, p->fname, p->pos.line, p->pos.col,
+	    level, text);
+	free(text);
+}
 
 static void
 error_msg(struct parse *p, const char *fmt, ...)
 {
 	va_list		 ap;
 
-	fprintf(stderr, "%s:%d:%d: ERROR: ", p->fname, p->line, p->col);
 	va_start(ap, fmt);
-	vfprintf(stderr, fmt, ap);
+	parse_msg(p, MSG_ERROR, fmt, ap);
 	va_end(ap);
-	fputc('\n', stderr);
 	p->tree->flags |= TREE_ERROR;
+	p->taint++;
 }
 
 static void
@@ -214,26 +323,84 @@ warn_msg(struct parse *p, const char *fmt, ...)
 {
 	va_list		 ap;
 
+	p->taint++;
 	if ((p->flags & PFLAG_WARN) == 0)
 		return;
 
-	fprintf(stderr, "%s:%d:%d: WARNING: ", p->fname, p->line, p->col);
 	va_start(ap, fmt);
-	vfprintf(stderr, fmt, ap);
+	parse_msg(p, MSG_WARNING, fmt, ap);
 	va_end(ap);
-	fputc('\n', stderr);
 	p->tree->flags |= TREE_WARN;
 }
 
+/*
+ * Decide whether text following the node np without intervening
+ * whitespace continues the in-line macro generated for np.
+ */
+static int
+pnode_joins(struct pnode *np)
+{
+	while (np != NULL) {
+		switch (np->class) {
+		case CLASS_VOID:
+		case CLASS_TEXT:
+		case CLASS_BLOCK:
+		case CLASS_NOFILL:
+			return 0;
+		case CLASS_TRANS:
+			np = PNODE_LAST(np);
+			continue;
+		case CLASS_LINE:
+		case CLASS_ENCL:
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * When the parser is done with the byte after a text node pointing
+ * into the input buffer, that is, once the byte is before cp,
+ * overwrite it with NUL to terminate the text.  Newlines are counted
+ * before, since they are needed for the line numbers in messages.
+ */
+static void
+text_term(struct parse *p, const char *cp)
+{
+	if (p->tend == NULL || p->tend >= cp)
+		return;
+	if (*p->tend == '\n')
+		ppos_count(&p->pos, p->tend + 1);
+	*p->tend = '\0';
+	p->tend = NULL;
+}
+
+/*
+ * Set the string of the new text node n to the sz bytes at word.
+ * If the input buffer outlives the tree, point into it;
+ * the byte after the text is overwritten by text_term() later.
+ */
+static void
+pnode_settext(struct parse *p, struct pnode *n, char *word, size_t sz)
+{
+	if (p->flags & PFLAG_KEEP) {
+		text_term(p, word);
+		n->u.b = word;
+		p->tend = word + sz;
+	} else
+		n->u.b = arena_strndup(p->tree->arena, word, sz);
+}
+
 /*
  * Process a string of characters.
  * If a text node is already open, append to it.
  * Otherwise, create a new one as a child of the current node.
  */
 static void
-xml_text(struct parse *p, const char *word, int sz)
+xml_text(struct parse *p, char *word, int sz)
 {
 	struct pnode	*n, *np;
+	char		*cp;
 	size_t		 oldsz, newsz;
 	int		 i;
 
@@ -250,15 +417,22 @@ xml_text(struct parse *p, const char *word, int sz)
 	/* Append to the current text node, if one is open. */
 
 	if (n->node == NODE_TEXT) {
-		oldsz = strlen(n->b);
+		oldsz = p->tlen;
 		newsz = oldsz + sz;
 		if (oldsz && (p->flags & PFLAG_SPC))
 			newsz++;
-		n->b = xrealloc(n->b, newsz + 1);
+		if (newsz >= p->tsz) {
+			while (newsz >= p->tsz)
+				p->tsz *= 2;
+			cp = arena_calloc(p->tree->arena, 1, p->tsz);
+			memcpy(cp, n->u.b, oldsz);
+			n->u.b = cp;
+		}
 		if (oldsz && (p->flags & PFLAG_SPC))
-			n->b[oldsz++] = ' ';
-		memcpy(n->b + oldsz, word, sz);
-		n->b[newsz] = '\0';
+			n->u.b[oldsz++] = ' ';
+		memcpy(n->u.b + oldsz, word, sz);
+		n->u.b[newsz] = '\0';
+		p->tlen = newsz;
 		p->flags &= ~(PFLAG_LINE | PFLAG_SPC);
 		return;
 	}
@@ -268,9 +442,10 @@ xml_text(struct parse *p, const char *word, int sz)
 
 	/* Create a new text node. */
 
-	n = pnode_alloc(p->cur);
-	n->node = NODE_TEXT;
-	if (p->flags & PFLAG_LINE && TAILQ_PREV(n, pnodeq, child) != NULL)
+	n = pnode_alloc(p->tree->arena, p->cur);
+	pnode_settype(n, NODE_TEXT);
+	ptree_append(p->tree, n);
+	if (p->flags & PFLAG_LINE && PNODE_PREV(n) != NULL)
 		n->flags |= NFLAG_LINE;
 	if (p->flags & PFLAG_SPC)
 		n->flags |= NFLAG_SPC;
@@ -282,29 +457,12 @@ xml_text(struct parse *p, const char *word, int sz)
 	 * and do not keep it open.
 	 */
 
-	np = n->flags & NFLAG_SPC ? NULL : TAILQ_PREV(n, pnodeq, child);
-	while (np != NULL) {
-		switch (pnode_class(np->node)) {
-		case CLASS_VOID:
-		case CLASS_TEXT:
-		case CLASS_BLOCK:
-		case CLASS_NOFILL:
-			np = NULL;
-			break;
-		case CLASS_TRANS:
-			np = TAILQ_LAST(&np->childq, pnodeq);
-			continue;
-		case CLASS_LINE:
-		case CLASS_ENCL:
-			break;
-		}
-		break;
-	}
-	if (np != NULL) {
+	np = n->flags & NFLAG_SPC ? NULL : PNODE_PREV(n);
+	if (pnode_joins(np)) {
 		i = 0;
 		while (i < sz && !isspace((unsigned char)word[i]))
 			i++;
-		n->b = xstrndup(word, i);
+		pnode_settext(p, n, word, i);
 		if (i == sz)
 			return;
 		while (i < sz && isspace((unsigned char)word[i]))
@@ -316,17 +474,24 @@ xml_text(struct parse *p, const char *word, int sz)
 
 		/* Put any remaining text into a second node. */
 
-		n = pnode_alloc(p->cur);
-		n->node = NODE_TEXT;
+		n = pnode_alloc(p->tree->arena, p->cur);
+		pnode_settype(n, NODE_TEXT);
+		ptree_append(p->tree, n);
 		n->flags |= NFLAG_SPC;
 		word += i;
 		sz -= i;
 	}
-	n->b = xstrndup(word, sz);
+	pnode_settext(p, n, word, sz);
 
-	/* The new node remains open for later pnode_closetext(). */
+	/*
+	 * The new node remains open for later pnode_closetext().
+	 * Its buffer grows geometrically while text is appended.
+	 * Text pointing into the input has no room to grow at all.
+	 */
 
 	p->cur = n;
+	p->tlen = sz;
+	p->tsz = p->flags & PFLAG_KEEP ? sz : sz + 1;
 }
 
 /*
@@ -341,8 +506,8 @@ pnode_closetext(struct parse *p, int check_last_word)
 	if ((n = p->cur) == NULL || n->node != NODE_TEXT)
 		return;
 	p->cur = n->parent;
-	for (cp = strchr(n->b, '\0');
-	    cp > n->b && isspace((unsigned char)cp[-1]);
+	for (cp = n->u.b + p->tlen;
+	    cp > n->u.b && isspace((unsigned char)cp[-1]);
 	    *--cp = '\0')
 		p->flags |= PFLAG_SPC;
 
@@ -354,29 +519,241 @@ pnode_closetext(struct parse *p, int check_last_word)
 	 * and delete whitespace before it.
 	 */
 
-	while (cp > n->b && !isspace((unsigned char)cp[-1]))
+	while (cp > n->u.b && !isspace((unsigned char)cp[-1]))
 		cp--;
 	last_word = cp;
-	while (cp > n->b && isspace((unsigned char)cp[-1]))
+	while (cp > n->u.b && isspace((unsigned char)cp[-1]))
 		cp--;
-	if (cp == n->b)
+	if (cp == n->u.b)
 		return;
 	*cp = '\0';
 
 	/* Move the last word into its own node, for use with .Pf. */
 
-	n = pnode_alloc_text(p->cur, last_word);
+	n = pnode_alloc(p->tree->arena, p->cur);
+	pnode_settype(n, NODE_TEXT);
+	ptree_append(p->tree, n);
+	n->u.b = last_word;
 	n->flags |= NFLAG_SPC;
 }
 
+/*
+ * Add an entity to the hash table, unless the name is already there.
+ */
+static void
+entity_add(struct parse *p, const char *name, const char *value,
+    enum enttype type)
+{
+	struct entdecl	*e, **ents, **bp;
+	size_t		 i, nb;
+	unsigned int	 h;
+
+	if (p->ents == NULL) {
+		p->entnb = ENT_NBUCKETS;
+		p->ents = xcalloc(p->entnb, sizeof(*p->ents));
+	}
+	h = name_hash(name, 0);
+	for (e = p->ents[h & (p->entnb - 1)]; e != NULL; e = e->next)
+		if (strcmp(e->name, name) == 0)
+			return;
+
+	/* Keep the load factor below one. */
+
+	if (p->entsz == p->entnb) {
+		nb = p->entnb * 2;
+		ents = xcalloc(nb, sizeof(*ents));
+		for (i = 0; i < p->entnb; i++) {
+			while ((e = p->ents[i]) != NULL) {
+				p->ents[i] = e->next;
+				bp = ents + (name_hash(e->name, 0) & (nb - 1));
+				e->next = *bp;
+				*bp = e;
+			}
+		}
+		free(p->ents);
+		p->ents = ents;
+		p->entnb = nb;
+	}
+	e = xcalloc(1, sizeof(*e));
+	e->name = name;
+	e->value = value;
+	e->type = type;
+	e->seq = p->entsz++;
+	bp = p->ents + (h & (p->entnb - 1));
+	e->next = *bp;
+	*bp = e;
+}
+
+static struct entdecl *
+entity_find(struct parse *p, const char *name)
+{
+	struct entdecl	*e;
+
+	if (p->ents == NULL)
+		return NULL;
+	for (e = p->ents[name_hash(name, 0) & (p->entnb - 1)];
+	    e != NULL; e = e->next)
+		if (strcmp(e->name, name) == 0)
+			return e;
+	return NULL;
+}
+
+static void
+entity_free(struct parse *p)
+{
+	struct entdecl	*e;
+	struct frag	*f;
+	size_t		 i;
+
+	for (i = 0; i < p->entnb; i++) {
+		while ((e = p->ents[i]) != NULL) {
+			p->ents[i] = e->next;
+			while ((f = e->frags) != NULL) {
+				e->frags = f->next;
+				frag_free(f);
+			}
+			free(e);
+		}
+	}
+	free(p->ents);
+	p->ents = NULL;
+	p->entnb = p->entsz = 0;
+}
+
+/*
+ * Add the entity declared by the doctype child n to the hash table.
+ */
+static void
+xml_entity_decl(struct parse *p, struct pnode *n)
+{
+	const char	*name, *value;
+
+	if ((name = pnode_getattr_raw(n, ATTRKEY_NAME, NULL)) == NULL)
+		return;
+	if ((value = pnode_getattr_raw(n, ATTRKEY_SYSTEM, NULL)) != NULL)
+		entity_add(p, name, value, ENT_SYSTEM);
+	else if ((value = pnode_getattr_raw(n,
+	    ATTRKEY_DEFINITION, NULL)) != NULL)
+		entity_add(p, name, value, ENT_TEXT);
+}
+
+/*
+ * Look up the first declaration of an entity, given the entry e
+ * from the hash table or NULL, taking into account the snapshots
+ * of entity files included before that declaration.
+ * Return its value or NULL if it is not declared,
+ * and set *system if the value is a system identifier.
+ */
+static const char *
+xml_entity_lookup(struct parse *p, const char *name,
+    const struct entdecl *e, int *system)
+{
+	const char		*ccp;
+	size_t			 i;
+
+	for (i = 0; i < p->snapsz; i++) {
+		if (e != NULL && p->snaps[i].seq > e->seq)
+			break;
+		if ((ccp = snap_lookup(p->snaps[i].snap,
+		    name, system)) != NULL)
+			return ccp;
+	}
+	if (e == NULL)
+		return NULL;
+	*system = e->type == ENT_SYSTEM;
+	return e->value;
+}
+
+/*
+ * Look up a built-in entity, and set *predef if it is
+ * one of the five entities predefined by XML.
+ */
+static const struct entity *
+entity_builtin(const char *name, int *predef)
+{
+	int	 i;
+
+	if ((i = name_find(&entitytab, name)) == -1 ||
+	    strcmp(name, entities[i].name) != 0)
+		return NULL;
+	*predef = strcmp(name, "amp") == 0 || strcmp(name, "apos") == 0 ||
+	    strcmp(name, "gt") == 0 || strcmp(name, "lt") == 0 ||
+	    strcmp(name, "quot") == 0;
+	return entities + i;
+}
+
+/*
+ * Parse the decimal or hexadecimal number of a character reference
+ * following the '#'.  Return the codepoint or -1 if it is invalid.
+ */
+static int
+xml_charref(const char *cp)
+{
+	int	 base, codepoint, digit;
+
+	base = 10;
+	if (*cp == 'x') {
+		base = 16;
+		cp++;
+	}
+	if (*cp == '\0')
+		return -1;
+	for (codepoint = 0; *cp != '\0'; cp++) {
+		if (isdigit((unsigned char)*cp))
+			digit = *cp - '0';
+		else if (base == 16 && isxdigit((unsigned char)*cp))
+			digit = tolower((unsigned char)*cp) - 'a' + 10;
+		else
+			return -1;
+		if ((codepoint = codepoint * base + digit) > 0x10ffff)
+			return -1;
+	}
+	return codepoint;
+}
+
+/*
+ * Parse the replacement text of the internal entity e at the current
+ * position.  Within the document, the expansion only depends on the
+ * context, so reuse the parse tree of an earlier expansion if possible.
+ */
+static void
+xml_entity_expand(struct parse *p, struct entdecl *e)
+{
+	struct fragstate fs;
+	struct frag	*f, *rec;
+	char		*cp;
+	enum pstate	 pstate;
+	int		 ctx;
+
+	rec = NULL;
+	if ((ctx = frag_context(p)) != -1) {
+		ctx |= FCTX_ENTITY;
+		for (f = e->frags; f != NULL; f = f->next) {
+			if (f->ctx == ctx) {
+				frag_use(p, f);
+				return;
+			}
+		}
+		rec = frag_start(p, ctx, &fs);
+	}
+	cp = xstrdup(e->value);
+	pstate = PARSE_ELEM;
+	parse_string(p, cp, strlen(cp), &pstate, 0);
+	free(cp);
+	if (rec != NULL)
+		frag_finish(p, rec, &fs, &e->frags);
+}
+
 static void
 xml_entity(struct parse *p, const char *name)
 {
 	const struct entity	*entity;
+	struct entdecl		*e;
 	struct pnode		*n;
 	const char		*ccp;
 	char			*cp;
-	unsigned int		 codepoint;
+	char			 buf[16];
+	int			 codepoint, predef, system;
 	enum pstate		 pstate;
 
 	if (p->del > 0)
@@ -392,52 +769,46 @@ xml_entity(struct parse *p, const char *name)
 	if (p->tree->flags & TREE_CLOSED && p->cur == p->tree->root)
 		warn_msg(p, "entity after end of document: &%s;", name);
 
-	for (entity = entities; entity->name != NULL; entity++)
-		if (strcmp(name, entity->name) == 0)
-			break;
-
-	if (entity->roff == NULL) {
-		if (p->doctype != NULL) {
-			TAILQ_FOREACH(n, &p->doctype->childq, child) {
-				if ((ccp = pnode_getattr_raw(n,
-				     ATTRKEY_NAME, NULL)) == NULL ||
-				    strcmp(ccp, name) != 0)
-					continue;
-				if ((ccp = pnode_getattr_raw(n,
-				    ATTRKEY_SYSTEM, NULL)) != NULL) {
-					parse_file(p, -1, ccp);
-					p->flags &= ~(PFLAG_LINE | PFLAG_SPC);
-					return;
-				}
-				if ((ccp = pnode_getattr_raw(n,
-				     ATTRKEY_DEFINITION, NULL)) == NULL)
-					continue;
-				cp = xstrdup(ccp);
-				pstate = PARSE_ELEM;
-				parse_string(p, cp, strlen(cp), &pstate, 0);
-				p->flags &= ~(PFLAG_LINE | PFLAG_SPC);
-				free(cp);
-				return;
-			}
+	/*
+	 * Declarations take precedence over built-in entities,
+	 * except for those predefined by XML.
+	 */
+	predef = 0;
+	entity = entity_builtin(name, &predef);
+	if (p->doctype != NULL && predef == 0) {
+		p->taint++;
+		p->nref++;
+		e = entity_find(p, name);
+		ccp = xml_entity_lookup(p, name, e, &system);
+		if (ccp != NULL && system)
+			parse_file(p, -1, ccp);
+		else if (e != NULL && ccp == e->value)
+			xml_entity_expand(p, e);
+		else if (ccp != NULL) {
+			cp = xstrdup(ccp);
+			pstate = PARSE_ELEM;
+			parse_string(p, cp, strlen(cp), &pstate, 0);
+			free(cp);
 		}
-		if (*name == '#') {
-			codepoint = strtonum(name + 1, 0, 0x10ffff, &ccp);
-			if (ccp == NULL) {
-				n = pnode_alloc(p->cur);
-				xasprintf(&n->b, "\\[u%4.4X]", codepoint);
-				goto done;
-			}
+		if (ccp != NULL) {
+			p->flags &= ~(PFLAG_LINE | PFLAG_SPC);
+			return;
 		}
-		error_msg(p, "unknown entity &%s;", name);
-		return;
 	}
 
 	/* Create, append, and close out an entity node. */
-	n = pnode_alloc(p->cur);
-	n->b = xstrdup(entity->roff);
-done:
-	n->node = NODE_ESCAPE;
-	if (p->flags & PFLAG_LINE && TAILQ_PREV(n, pnodeq, child) != NULL)
+	if (entity != NULL)
+		n = pnode_alloc_text(p->tree->arena, p->cur, entity->roff);
+	else if (*name == '#' && (codepoint = xml_charref(name + 1)) != -1) {
+		snprintf(buf, sizeof(buf), "\\[u%4.4X]", codepoint);
+		n = pnode_alloc_text(p->tree->arena, p->cur, buf);
+	} else {
+		error_msg(p, "unknown entity &%s;", name);
+		return;
+	}
+	pnode_settype(n, NODE_ESCAPE);
+	ptree_append(p->tree, n);
+	if (p->flags & PFLAG_LINE && PNODE_PREV(n) != NULL)
 		n->flags |= NFLAG_LINE;
 	if (p->flags & PFLAG_SPC)
 		n->flags |= NFLAG_SPC;
@@ -450,17 +821,11 @@ done:
 static enum nodeid
 xml_name2node(struct parse *p, const char *name)
 {
-	const struct alias	*alias;
 	enum nodeid		 node;
 
 	if ((node = pnode_parse(name)) < NODE_UNKNOWN)
 		return node;
-
-	for (alias = aliases; alias->name != NULL; alias++)
-		if (strcmp(alias->name, name) == 0)
-			return alias->node;
-
-	return NODE_UNKNOWN;
+	return pnode_alias(name);
 }
 
 /*
@@ -511,9 +876,9 @@ xml_elem_start(struct parse *p, const char *name)
 		break;
 	}
 
-	n = pnode_alloc(p->cur);
+	n = pnode_alloc(p->tree->arena, p->cur);
 	if (p->flags & PFLAG_LINE && p->cur != NULL &&
-	    TAILQ_PREV(n, pnodeq, child) != NULL)
+	    PNODE_PREV(n) != NULL)
 		n->flags |= NFLAG_LINE;
 	p->flags &= ~PFLAG_LINE;
 
@@ -523,7 +888,9 @@ xml_elem_start(struct parse *p, const char *name)
 	 * printing text always want whitespace before themselves.
 	 */
 
-	switch (n->node = p->ncur) {
+	pnode_settype(n, p->ncur);
+	ptree_append(p->tree, n);
+	switch (n->node) {
 	case NODE_DOCTYPE:
 	case NODE_ENTITY:
 	case NODE_SBR:
@@ -533,7 +900,7 @@ xml_elem_start(struct parse *p, const char *name)
 	default:
 		break;
 	}
-	switch (pnode_class(p->ncur)) {
+	switch (n->class) {
 	case CLASS_LINE:
 	case CLASS_ENCL:
 		if (p->flags & PFLAG_SPC)
@@ -556,6 +923,19 @@ xml_elem_start(struct parse *p, const char *name)
 		p->tree->root = n;
 }
 
+/*
+ * Set the raw value of the new attribute a.
+ * If the input buffer outlives the tree, point into it.
+ */
+static void
+pattr_setval(struct parse *p, struct pattr *a, const char *value)
+{
+	if (p->flags & PFLAG_KEEP)
+		a->rawval = (char *)value;
+	else
+		a->rawval = arena_strdup(p->tree->arena, value);
+}
+
 static void
 xml_attrkey(struct parse *p, const char *name)
 {
@@ -567,27 +947,25 @@ xml_attrkey(struct parse *p, const char *name)
 		return;
 
 	if ((p->ncur == NODE_DOCTYPE || p->ncur == NODE_ENTITY) &&
-	    TAILQ_FIRST(&p->cur->attrq) == NULL) {
+	    p->cur->u.attr == NULL) {
 		value = name;
 		name = "NAME";
 	} else
 		value = NULL;
 
-	if ((key = attrkey_parse(name)) == ATTRKEY__MAX) {
+	/* Discard unknown and repeated attributes. */
+
+	if ((key = attrkey_parse(name)) == ATTRKEY__MAX ||
+	    (a = pnode_addattr(p->tree->arena, p->cur, key)) == NULL) {
 		p->flags &= ~PFLAG_ATTR;
 		return;
 	}
-	a = xcalloc(1, sizeof(*a));
-	a->key = key;
-	a->val = ATTRVAL__MAX;
-	if (value == NULL) {
-		a->rawval = NULL;
+	if (value == NULL)
 		p->flags |= PFLAG_ATTR;
-	} else {
-		a->rawval = xstrdup(value);
+	else {
+		pattr_setval(p, a, value);
 		p->flags &= ~PFLAG_ATTR;
 	}
-	TAILQ_INSERT_TAIL(&p->cur->attrq, a, child);
 	if (p->ncur == NODE_ENTITY && key == ATTRKEY_NAME)
 		xml_attrkey(p, "DEFINITION");
 }
@@ -595,15 +973,17 @@ xml_attrkey(struct parse *p, const char *name)
 static void
 xml_attrval(struct parse *p, const char *name)
 {
+	struct pattrs	*as;
 	struct pattr	*a;
 
 	if (p->del > 0 || p->ncur >= NODE_UNKNOWN ||
 	    (p->flags & PFLAG_ATTR) == 0)
 		return;
-	if ((a = TAILQ_LAST(&p->cur->attrq, pattrq)) == NULL)
+	if ((as = p->cur->u.attr) == NULL)
 		return;
+	a = as->a + as->num - 1;
 	if ((a->val = attrval_parse(name)) == ATTRVAL__MAX)
-		a->rawval = xstrdup(name);
+		pattr_setval(p, a, name);
 	p->flags &= ~PFLAG_ATTR;
 }
 
@@ -650,7 +1030,7 @@ xml_elem_end(struct parse *p, const char *name)
 			    "without href attribute");
 		else
 			parse_file(p, -1, cp);
-		pnode_unlink(n);
+		ptree_unlink(p->tree, n);
 		p->flags &= ~(PFLAG_LINE | PFLAG_SPC);
 		break;
 	case NODE_DOCTYPE:
@@ -681,12 +1061,22 @@ xml_elem_end(struct parse *p, const char *name)
 			p->tree->flags |= TREE_CLOSED;
 		p->flags &= ~(PFLAG_LINE | PFLAG_SPC);
 
+		if (node == NODE_ENTITY && p->doctype != NULL &&
+		    n->parent == p->doctype)
+			xml_entity_decl(p, n);
+
 		/* Include a file containing entity declarations. */
 
 		if (node == NODE_ENTITY && strcmp("%",
 		    pnode_getattr_raw(n, ATTRKEY_NAME, "")) == 0 &&
 		    (cp = pnode_getattr_raw(n, ATTRKEY_SYSTEM, NULL)) != NULL)
-			parse_file(p, -1, cp);
+			parse_entfile(p, n, cp);
+
+		/* Only the first doctype is kept until the end. */
+
+		if (node == NODE_DOCTYPE && n != p->doctype &&
+		    n->parent == NULL)
+			ptree_unlink(p->tree, n);
 
 		break;
 	}
@@ -700,6 +1090,9 @@ parse_alloc(int warn)
 
 	p = xcalloc(1, sizeof(*p));
 	p->tree = xcalloc(1, sizeof(*p->tree));
+	p->tree->arena = arena_alloc();
+	p->flags |= PFLAG_ARENA;
+	p->dirfd = AT_FDCWD;
 	if (warn)
 		p->flags |= PFLAG_WARN;
 	else
@@ -707,42 +1100,202 @@ parse_alloc(int warn)
 	return p;
 }
 
+/*
+ * Pass messages to func instead of printing them to stderr.
+ */
+void
+parse_setmsg(struct parse *p, pmsg_func *func, void *arg)
+{
+	p->msgfunc = func;
+	p->msgarg = arg;
+}
+
+/*
+ * Pass the name of each file the parser tries to open to func,
+ * either an absolute path or a path relative to the current working
+ * directory, together with a flag telling whether opening succeeded.
+ */
+void
+parse_setfile(struct parse *p, pfile_func *func, void *arg)
+{
+	p->filefunc = func;
+	p->filearg = arg;
+}
+
+/*
+ * Allocate the parse tree from the arena a instead of a new one.
+ * The caller releases the memory after parse_free(),
+ * for example with arena_reset() to reuse it for the next document.
+ * This has to be called before parsing.
+ */
+void
+parse_setarena(struct parse *p, struct arena *a)
+{
+	if (p->flags & PFLAG_ARENA)
+		arena_free(p->tree->arena);
+	p->tree->arena = a;
+	p->flags &= ~PFLAG_ARENA;
+}
+
 void
 parse_free(struct parse *p)
 {
+	struct pmap	*m;
+
 	if (p == NULL)
 		return;
 	if (p->tree != NULL) {
-		pnode_unlink(p->tree->root);
+		if (p->flags & PFLAG_ARENA)
+			arena_free(p->tree->arena);
 		free(p->tree);
 	}
+	while ((m = p->maps) != NULL) {
+		p->maps = m->next;
+		munmap(m->b, m->sz);
+		free(m);
+	}
+	snap_release(p);
+	free(p->snaps);
+	entity_free(p);
 	free(p);
 }
 
-static void
-increment(struct parse *p, char *b, size_t *pend, int refill)
+/*
+ * Skip the rest of a comment, a processing instruction, or a
+ * markup declaration other than a doctype or entity declaration.
+ * If the end is not in the buffer but more input may follow,
+ * skip all bytes except those that may start the delimiter
+ * and return 1; the next call continues in the same state.
+ * Otherwise, return 0.
+ */
+static int
+skip_markup(char *b, size_t rlen, size_t *pend, enum pstate *pstate,
+    int flags)
 {
-	if (refill) {
-		if (b[*pend] == '\n') {
-			p->nline++;
-			p->ncol = 1;
-		} else
-			p->ncol++;
+	const char	*cp, *ep, *delim;
+	size_t		 dsz;
+
+	cp = b + *pend;
+	ep = b + rlen;
+	for (;;) {
+		switch (*pstate) {
+		case PARSE_COMMENT:
+		case PARSE_PI:
+			delim = *pstate == PARSE_COMMENT ? "-->" : "?>";
+			dsz = strlen(delim);
+			if ((cp = memmem(cp, ep - cp, delim, dsz)) != NULL) {
+				*pstate = PARSE_ELEM;
+				cp += dsz;
+			} else if (flags & PSTR_REFILL) {
+				cp = ep - b - *pend < dsz ? b + *pend :
+				    ep - (dsz - 1);
+				*pend = cp - b;
+				return 1;
+			} else
+				cp = ep;
+			break;
+		case PARSE_DECL:
+			while (cp < ep && *cp != '>' &&
+			    *cp != '"' && *cp != '\'')
+				cp++;
+			if (cp == ep)
+				break;
+			if (*cp++ == '>') {
+				*pstate = PARSE_ELEM;
+				break;
+			}
+			*pstate = cp[-1] == '"' ? PARSE_DECLDQ : PARSE_DECLSQ;
+			continue;
+		default:
+			cp = memchr(cp, *pstate == PARSE_DECLDQ ? '"' : '\'',
+			    ep - cp);
+			if (cp == NULL) {
+				cp = ep;
+				break;
+			}
+			cp++;
+			*pstate = PARSE_DECL;
+			continue;
+		}
+		break;
+	}
+	*pend = cp - b;
+	return 0;
+}
+
+/*
+ * Return the offset of the first byte in b[0..len) that is in the
+ * charset or NUL, or whitespace if space is set; or len if none is.
+ * Whitespace is what isspace(3) accepts in the C locale.
+ * Where SSE2 is available, which includes all amd64 processors,
+ * 16 bytes are compared at a time, and the rest byte by byte
+ * using a bitmap of the delimiters.
+ */
+static size_t
+scan_delim(const char *b, size_t len, const char *charset, int space)
+{
+	unsigned char	 map[256 / 8];
+	const char	*cp;
+	size_t		 i;
+	unsigned char	 c;
+#ifdef __SSE2__
+	__m128i		 set[4], v, m, t;
+	int		 bits, j, nset;
+
+	for (nset = 0; nset < 4 && charset[nset] != '\0'; nset++)
+		set[nset] = _mm_set1_epi8(charset[nset]);
+	i = 0;
+	if (charset[nset] == '\0') {
+		for (; i + 16 <= len; i += 16) {
+			v = _mm_loadu_si128((const __m128i *)(b + i));
+			m = _mm_cmpeq_epi8(v, _mm_setzero_si128());
+			for (j = 0; j < nset; j++)
+				m = _mm_or_si128(m, _mm_cmpeq_epi8(v, set[j]));
+			if (space) {
+				m = _mm_or_si128(m,
+				    _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+				t = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+				m = _mm_or_si128(m, _mm_cmpeq_epi8(t,
+				    _mm_min_epu8(t, _mm_set1_epi8(4))));
+			}
+			if ((bits = _mm_movemask_epi8(m)) != 0)
+				return i + __builtin_ctz(bits);
+		}
+	}
+#else
+	i = 0;
+#endif
+	memset(map, 0, sizeof(map));
+	map[0] = 1;
+	for (cp = charset; *cp != '\0'; cp++) {
+		c = *cp;
+		map[c >> 3] |= 1 << (c & 7);
 	}
-	++*pend;
+	if (space)
+		for (cp = " \t\n\v\f\r"; *cp != '\0'; cp++) {
+			c = *cp;
+			map[c >> 3] |= 1 << (c & 7);
+		}
+	for (; i < len; i++) {
+		c = b[i];
+		if (map[c >> 3] & (1 << (c & 7)))
+			break;
+	}
+	return i;
 }
 
 /*
  * Advance the pend pointer to the next character in the charset.
  * If the charset starts with a space, it stands for any whitespace.
- * Update the new input file position, used for messages.
  * Do not overrun the buffer b of length rlen.
  * When reaching the end, NUL-terminate the buffer and return 1;
  * otherwise, return 0.
+ * If the previous call of parse_string() ended in the middle
+ * of this token, continue scanning where it left off.
  */
 static int
 advance(struct parse *p, char *b, size_t rlen, size_t *pend,
-    const char *charset, int refill)
+    const char *charset, int flags)
 {
 	int		 space;
 
@@ -752,52 +1305,68 @@ advance(struct parse *p, char *b, size_t rlen, size_t *pend,
 	} else
 		space = 0;
 
-	if (refill) {
-		p->nline = p->line;
-		p->ncol = p->col;
-	}
-	while (*pend < rlen) {
-		if (space && isspace((unsigned char)b[*pend]))
-			break;
-		if (strchr(charset, b[*pend]) != NULL)
-			break;
-		increment(p, b, pend, refill);
-	}
+	*pend += p->resume;
+	p->resume = 0;
+	*pend += scan_delim(b + *pend, rlen - *pend, charset, space);
 	if (*pend == rlen) {
 		b[rlen] = '\0';
-		return refill;
+		return (flags & PSTR_REFILL) != 0;
 	} else
 		return 0;
 }
 
 size_t
 parse_string(struct parse *p, char *b, size_t rlen,
-    enum pstate *pstate, int refill)
+    enum pstate *pstate, int flags)
 {
-	char		*cp;
 	size_t		 pws;	/* Parse offset including whitespace. */
 	size_t		 poff;  /* Parse offset in b[]. */
 	size_t		 pend;  /* Offset of the end of the current word. */
-	int		 elem_end;
+	enum nodeid	 node;
+	int		 elem_end, keep;
+
+	keep = p->flags & PFLAG_KEEP;
+	if (flags & PSTR_KEEP)
+		p->flags |= PFLAG_KEEP;
+	else
+		p->flags &= ~PFLAG_KEEP;
 
 	pend = pws = 0;
 	for (;;) {
 
 		/* Proceed to the next token, skipping whitespace. */
 
-		if (refill) {
-			p->line = p->nline;
-			p->col = p->ncol;
-		}
-		if ((poff = pend) == rlen)
+		if (flags & PSTR_TRACK)
+			p->pos.tok = b + pend;
+		text_term(p, b + pend);
+		if ((poff = pend) == rlen) {
+			if (flags & PSTR_REFILL && p->nofill &&
+			    *pstate == PARSE_ELEM)
+				poff = pws;
 			break;
+		}
+
+		/*
+		 * Comments, processing instructions, and markup
+		 * declarations other than doctype and entity
+		 * declarations are skipped without tokenizing them.
+		 */
+
+		if (*pstate >= PARSE_COMMENT) {
+			if (skip_markup(b, rlen, &pend, pstate, flags)) {
+				poff = pend;
+				break;
+			}
+			pws = pend;
+			continue;
+		}
 		if (isspace((unsigned char)b[pend])) {
 			p->flags |= PFLAG_SPC;
 			if (b[pend] == '\n') {
 				p->flags |= PFLAG_LINE;
 				pws = pend + 1;
 			}
-			increment(p, b, &pend, refill);
+			pend++;
 			continue;
 		}
 
@@ -805,8 +1374,9 @@ parse_string(struct parse *p, char *b, size_t rlen,
 		 * The following four cases (ARG, TAG, and starting an
 		 * entity or a tag) all parse a word or quoted string.
 		 * If that extends beyond the read buffer and the last
-		 * read(2) still got data, they all break out of the
-		 * token loop to request more data from the read loop.
+		 * read(2) still got data, they all jump out of the
+		 * token loop to request more data from the read loop,
+		 * remembering how much of the token was already scanned.
 		 *
 		 * Also, three of them detect self-closing tags, those
 		 * ending with "/>", setting the flag elem_end and
@@ -822,13 +1392,13 @@ parse_string(struct parse *p, char *b, size_t rlen,
 			    (b[pend] == '\'' || b[pend] == '"')) {
 				*pstate = b[pend] == '"' ?
 				    PARSE_DQ : PARSE_SQ;
-				increment(p, b, &pend, refill);
+				pend++;
 				continue;
 			}
 			if (advance(p, b, rlen, &pend,
 			    *pstate == PARSE_DQ ? "\"" :
-			    *pstate == PARSE_SQ ? "'" : " >", refill))
-				break;
+			    *pstate == PARSE_SQ ? "'" : " >", flags))
+				goto refill;
 			*pstate = PARSE_TAG;
 			elem_end = 0;
 			if (b[pend] == '>') {
@@ -842,7 +1412,7 @@ parse_string(struct parse *p, char *b, size_t rlen,
 			}
 			b[pend] = '\0';
 			if (pend < rlen)
-				increment(p, b, &pend, refill);
+				pend++;
 			xml_attrval(p, b + poff);
 			if (elem_end)
 				xml_elem_end(p, NULL);
@@ -854,7 +1424,7 @@ parse_string(struct parse *p, char *b, size_t rlen,
 			case NODE_DOCTYPE:
 				if (b[pend] == '[') {
 					*pstate = PARSE_ELEM;
-					increment(p, b, &pend, refill);
+					pend++;
 					continue;
 				}
 				/* FALLTHROUGH */
@@ -867,8 +1437,8 @@ parse_string(struct parse *p, char *b, size_t rlen,
 			default:
 				break;
 			}
-			if (advance(p, b, rlen, &pend, " =>", refill))
-				break;
+			if (advance(p, b, rlen, &pend, " =>", flags))
+				goto refill;
 			elem_end = 0;
 			switch (b[pend]) {
 			case '>':
@@ -888,7 +1458,7 @@ parse_string(struct parse *p, char *b, size_t rlen,
 			}
 			b[pend] = '\0';
 			if (pend < rlen)
-				increment(p, b, &pend, refill);
+				pend++;
 			xml_attrkey(p, b + poff);
 			if (elem_end)
 				xml_elem_end(p, NULL);
@@ -896,24 +1466,22 @@ parse_string(struct parse *p, char *b, size_t rlen,
 		/* Begin an opening or closing tag. */
 
 		} else if (b[poff] == '<') {
-			if (advance(p, b, rlen, &pend, " >", refill))
-				break;
-			if (pend > poff + 3 &&
-			    strncmp(b + poff, "<!--", 4) == 0) {
-
-				/* Skip a comment. */
-
-				cp = strstr(b + pend - 2, "-->");
-				if (cp == NULL) {
-					if (refill)
-						break;
-					cp = b + rlen;
-				} else
-					cp += 3;
-				while (b + pend < cp)
-					increment(p, b, &pend, refill);
+			if (rlen - poff < 4 && flags & PSTR_REFILL)
+				goto refill;
+			if (rlen - poff >= 4 &&
+			    memcmp(b + poff, "<!--", 4) == 0) {
+				*pstate = PARSE_COMMENT;
+				pend = poff + 4;
 				continue;
 			}
+			if (rlen - poff >= 2 && b[poff + 1] == '?') {
+				*pstate = PARSE_PI;
+				pend = poff + 2;
+				continue;
+			}
+			if (advance(p, b, rlen, &pend, " >", flags))
+				goto refill;
+			text_term(p, b + pend);
 			elem_end = 0;
 			if (b[pend] != '>')
 				*pstate = PARSE_TAG;
@@ -923,10 +1491,16 @@ parse_string(struct parse *p, char *b, size_t rlen,
 			}
 			b[pend] = '\0';
 			if (pend < rlen)
-				increment(p, b, &pend, refill);
+				pend++;
 			if (b[++poff] == '/') {
 				elem_end = 1;
 				poff++;
+			} else if (b[poff] == '!' && b[poff + 1] != '[' &&
+			    (node = xml_name2node(p, b + poff)) !=
+			    NODE_DOCTYPE && node != NODE_ENTITY) {
+				if (*pstate == PARSE_TAG)
+					*pstate = PARSE_DECL;
+				continue;
 			} else {
 				xml_elem_start(p, b + poff);
 				if (*pstate == PARSE_ELEM &&
@@ -940,24 +1514,37 @@ parse_string(struct parse *p, char *b, size_t rlen,
 
 		} else if (p->ncur == NODE_DOCTYPE && b[poff] == ']') {
 			*pstate = PARSE_TAG;
-			increment(p, b, &pend, refill);
+			pend++;
 
 		/* Process an entity. */
 
 		} else if (b[poff] == '&') {
-			if (advance(p, b, rlen, &pend, ";", refill))
-				break;
+			if (advance(p, b, rlen, &pend, ";", flags))
+				goto refill;
+			text_term(p, b + pend);
 			b[pend] = '\0';
 			if (pend < rlen)
-				increment(p, b, &pend, refill);
+				pend++;
 			xml_entity(p, b + poff + 1);
 
-		/* Process text up to the next tag, entity, or EOL. */
+		/*
+		 * Process text up to the next tag, entity, or EOL.
+		 * Like the other tokens, text reaching the end of the
+		 * buffer waits for more input, such that it ends up
+		 * in the same nodes whatever the buffer boundaries.
+		 * In no-fill displays, the whitespace before it is
+		 * needed, too, so it is scanned again after the refill,
+		 * like whitespace at the end of the buffer.
+		 */
 
 		} else {
-			advance(p, b, rlen, &pend,
+			if (advance(p, b, rlen, &pend,
 			    p->ncur == NODE_DOCTYPE ? "<&]\n" : "<&\n",
-			    refill);
+			    flags)) {
+				p->resume = pend - poff;
+				p->flags = (p->flags & ~PFLAG_KEEP) | keep;
+				return p->nofill ? pws : poff;
+			}
 			if (p->nofill)
 				poff = pws;
 			xml_text(p, b + poff, pend - poff);
@@ -966,102 +1553,751 @@ parse_string(struct parse *p, char *b, size_t rlen,
 		}
 		pws = pend;
 	}
+
+	/* At the end of the buffer, advance() wrote a NUL byte. */
+
+	p->tend = NULL;
+	p->flags = (p->flags & ~PFLAG_KEEP) | keep;
+	return poff;
+
+refill:
+	p->resume = pend - poff;
+	p->flags = (p->flags & ~PFLAG_KEEP) | keep;
 	return poff;
 }
 
 
 /*
- * The read loop.
+ * Parse a regular file of sz bytes in one go, without copying it.
+ * The private mapping allows the parser to write NUL bytes into it,
+ * and it is followed by at least one writable byte such that
+ * advance() can set b[sz] to NUL even if sz is a multiple of
+ * the page size.  Text and attribute values in the tree point
+ * into the mapping, so it is kept until parse_free().
+ * Return -1 if the file cannot be mapped.
+ */
+static int
+parse_map(struct parse *p, int fd, size_t sz)
+{
+	struct pmap	*m;
+	char		*b;
+	enum pstate	 pstate;
+
+	b = mmap(NULL, sz + 1, PROT_READ | PROT_WRITE,
+	    MAP_PRIVATE | MAP_ANON, -1, 0);
+	if (b == MAP_FAILED)
+		return -1;
+	if (mmap(b, sz, PROT_READ | PROT_WRITE,
+	    MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+		munmap(b, sz + 1);
+		return -1;
+	}
+	m = xcalloc(1, sizeof(*m));
+	m->b = b;
+	m->sz = sz + 1;
+	m->next = p->maps;
+	p->maps = m;
+	pstate = PARSE_ELEM;
+	ppos_start(&p->pos, b);
+	parse_string(p, b, sz, &pstate, PSTR_TRACK | PSTR_KEEP);
+	ppos_stop(&p->pos);
+	return 0;
+}
+
+/*
+ * The read loop, used unless the input is a regular file
+ * that can be mapped into memory.
  * If the previous token was incomplete and asked for more input,
  * we have to enter the read loop once more even on EOF.
  * Once rsz is 0, incomplete tokens will no longer ask for more input
  * but instead use whatever there is, and then exit the read loop.
+ * If a single token fills the whole buffer, the buffer grows.
  * The minus one on the size limit for read(2) is needed such that
  * advance() can set b[rlen] to NUL when needed.
  */
 static void
 parse_fd(struct parse *p, int fd)
 {
-	char		 b[4096];
+	char		*b;
+	size_t		 bsz;	/* Allocated size of b[]. */
 	ssize_t		 rsz;	/* Return value from read(2). */
 	size_t		 rlen;	/* Number of bytes in b[]. */
 	size_t		 poff;  /* Parse offset in b[]. */
+	struct stat	 st;
 	enum pstate	 pstate;
 
+	if (fd != STDIN_FILENO && fstat(fd, &st) == 0 &&
+	    S_ISREG(st.st_mode) && st.st_size > 0 &&
+	    (uintmax_t)st.st_size < SIZE_MAX &&
+	    parse_map(p, fd, st.st_size) == 0)
+		return;
+
+	bsz = PARSE_BUFSZ;
+	b = xcalloc(1, bsz);
 	rlen = 0;
 	pstate = PARSE_ELEM;
-	while ((rsz = read(fd, b + rlen, sizeof(b) - rlen - 1)) >= 0 &&
+	while ((rsz = read(fd, b + rlen, bsz - rlen - 1)) >= 0 &&
 	    (rlen += rsz) > 0) {
-		poff = parse_string(p, b, rlen, &pstate, rsz > 0);
+		if (p->pos.tok == NULL)
+			ppos_start(&p->pos, b);
+		poff = parse_string(p, b, rlen, &pstate,
+		    rsz > 0 ? PSTR_TRACK | PSTR_REFILL : PSTR_TRACK);
 		/* Buffer exhausted; shift left and re-fill. */
-		assert(poff > 0);
+		ppos_count(&p->pos, b + poff);
 		rlen -= poff;
-		memmove(b, b + poff, rlen);
+		if (poff > 0)
+			memmove(b, b + poff, rlen);
+		else if (rlen == bsz - 1) {
+			bsz *= 2;
+			b = xrealloc(b, bsz);
+		}
+		p->pos.tok = p->pos.mark = b;
 	}
+	ppos_stop(&p->pos);
+	p->resume = 0;
+	free(b);
 	if (rsz < 0)
 		error_msg(p, "read: %s", strerror(errno));
 }
 
+/*
+ * Construct the path to fname as seen from the current working
+ * directory, for a file name relative to the current input file.
+ */
+static char *
+parse_path(struct parse *p, const char *fname)
+{
+	char		*path;
+
+	if (*fname == '/' || p->dname == NULL)
+		return xstrdup(fname);
+	xasprintf(&path, "%s/%s", p->dname, fname);
+	return path;
+}
+
+/*
+ * Remember the directory containing the file fname, in case it
+ * wants to include any further files, which are typically
+ * given with relative paths in DocBook.
+ * Do this on a best-effort basis; don't complain about failure.
+ */
+static void
+parse_setdir(struct parse *p, const char *fname)
+{
+	char		*cp, *dname;
+	int		 save_dirfd;
+
+	save_dirfd = p->dirfd;
+	cp = xstrdup(fname);
+	if ((dname = dirname(cp)) != NULL && strcmp(dname, ".") != 0) {
+		if ((p->dirfd = openat(save_dirfd, dname,
+		    O_RDONLY | O_DIRECTORY, 0)) == -1)
+			p->dirfd = save_dirfd;
+		else
+			p->dname = parse_path(p, dname);
+	}
+	free(cp);
+}
+
+/*
+ * Restore the directory of the including file.
+ */
+static void
+parse_resetdir(struct parse *p, int save_dirfd, char *save_dname)
+{
+	if (p->dirfd == save_dirfd)
+		return;
+	close(p->dirfd);
+	p->dirfd = save_dirfd;
+	free(p->dname);
+	p->dname = save_dname;
+}
+
+/*
+ * Stop using the snapshots of entity files, freeing those
+ * that were removed from the cache in the meantime.
+ */
+static void
+snap_release(struct parse *p)
+{
+	struct snap	*s;
+
+	while (p->snapsz > 0) {
+		s = p->snaps[--p->snapsz].snap;
+		if (--s->nuse == 0 && s->stale)
+			snap_free(s);
+	}
+}
+
+/*
+ * On the top level, finalize the parse tree.
+ */
+static void
+parse_finish(struct parse *p)
+{
+	pnode_closetext(p, 0);
+	if (p->tree->root == NULL)
+		error_msg(p, "empty document");
+	else if ((p->tree->flags & TREE_CLOSED) == 0)
+		warn_msg(p, "document not closed");
+	ptree_unlink(p->tree, p->doctype);
+	p->doctype = NULL;
+	ptree_check(p->tree);
+	snap_release(p);
+	entity_free(p);
+}
+
+/*
+ * Unless dir is NULL, snapshots of entity files are also
+ * stored in that directory and reused by later processes.
+ */
+struct pcache *
+pcache_alloc(const char *dir)
+{
+	struct pcache	*c;
+
+	c = xcalloc(1, sizeof(*c));
+	if (dir != NULL)
+		c->dir = xstrdup(dir);
+	return c;
+}
+
+static void
+frag_free(struct frag *f)
+{
+	size_t		 i;
+
+	for (i = 0; i < f->filesz; i++)
+		free(f->files[i].path);
+	free(f->files);
+	arena_free(f->arena);
+	free(f);
+}
+
+void
+pcache_free(struct pcache *c)
+{
+	struct frag	*f;
+	struct snap	*s;
+
+	if (c == NULL)
+		return;
+	while ((f = c->frags) != NULL) {
+		c->frags = f->next;
+		frag_free(f);
+	}
+	while ((s = c->snaps) != NULL) {
+		c->snaps = s->next;
+		snap_free(s);
+	}
+	free(c->dir);
+	free(c);
+}
+
+/*
+ * Reuse the parse trees of included files from the cache c
+ * as long as the files do not change.
+ */
+void
+parse_setcache(struct parse *p, struct pcache *c)
+{
+	p->cache = c;
+}
+
+static struct ffile *
+frag_newfile(struct frag *f, const char *path)
+{
+	struct ffile	*ff;
+
+	if (f->filesz == f->filemax) {
+		f->filemax = f->filemax == 0 ? 4 : f->filemax * 2;
+		f->files = xreallocarray(f->files,
+		    f->filemax, sizeof(*f->files));
+	}
+	ff = f->files + f->filesz++;
+	ff->path = xstrdup(path);
+	return ff;
+}
+
+static void
+frag_copyfile(struct frag *f, const struct ffile *ff)
+{
+	struct ffile	*nf;
+
+	nf = frag_newfile(f, ff->path);
+	nf->dev = ff->dev;
+	nf->ino = ff->ino;
+	nf->size = ff->size;
+	nf->mtime = ff->mtime;
+}
+
+static void
+frag_addfile(struct frag *f, const char *path, const struct stat *st)
+{
+	struct ffile	*ff;
+
+	ff = frag_newfile(f, path);
+	ff->dev = st->st_dev;
+	ff->ino = st->st_ino;
+	ff->size = st->st_size;
+	ff->mtime = st->st_mtim;
+}
+
+/*
+ * Report a file that was read earlier, when the cached data
+ * derived from it was built, as if it had just been opened.
+ */
+static void
+ffile_report(struct parse *p, const struct ffile *ff)
+{
+	struct stat	 st;
+
+	if (p->filefunc == NULL)
+		return;
+	memset(&st, 0, sizeof(st));
+	st.st_dev = ff->dev;
+	st.st_ino = ff->ino;
+	st.st_size = ff->size;
+	st.st_mtim = ff->mtime;
+	(*p->filefunc)(p->filearg, ff->path, 1, &st);
+}
+
+static int
+ffile_same(const struct ffile *ff, const struct stat *st)
+{
+	return ff->dev == st->st_dev && ff->ino == st->st_ino &&
+	    ff->size == st->st_size &&
+	    ff->mtime.tv_sec == st->st_mtim.tv_sec &&
+	    ff->mtime.tv_nsec == st->st_mtim.tv_nsec;
+}
+
+/*
+ * Determine the context of including a file at the current position,
+ * see struct frag.  Return -1 if the parse tree of the included file
+ * can neither be taken from the cache nor stored in it.
+ */
+static int
+frag_context(struct parse *p)
+{
+	struct pnode	*last;
+	int		 ctx;
+
+	if (p->cur == NULL ||
+	    p->cur->node == NODE_TEXT || p->cur->node == NODE_DOCTYPE ||
+	    p->ncur == NODE_DOCTYPE || p->del > 0 ||
+	    p->flags & (PFLAG_ATTR | PFLAG_EEND))
+		return -1;
+	ctx = 0;
+	if (p->flags & PFLAG_LINE)
+		ctx |= FCTX_LINE;
+	if (p->flags & PFLAG_SPC)
+		ctx |= FCTX_SPC;
+	if (p->nofill)
+		ctx |= FCTX_NOFILL;
+	if ((last = PNODE_LAST(p->cur)) != NULL) {
+		ctx |= FCTX_PREV;
+		if (pnode_joins(last))
+			ctx |= FCTX_JOIN;
+	}
+	return ctx;
+}
+
+/*
+ * Find a fragment for the file path with the status st, parsed in
+ * the context ctx, such that none of the files it read changed since.
+ * Fragments found to be out of date on the way are freed, such that
+ * at most one fragment per file and context stays in the cache.
+ */
+static struct frag *
+frag_find(struct parse *p, const char *path, const struct stat *st,
+    int ctx)
+{
+	struct frag	**fp, *f;
+	struct stat	 fst;
+	size_t		 i;
+
+	fp = &p->cache->frags;
+	while ((f = *fp) != NULL) {
+		if (strcmp(f->files->path, path) != 0 ||
+		    (f->ctx != ctx && ffile_same(f->files, st))) {
+			fp = &f->next;
+			continue;
+		}
+		if (ffile_same(f->files, st)) {
+			for (i = 1; i < f->filesz; i++)
+				if (stat(f->files[i].path, &fst) == -1 ||
+				    ffile_same(f->files + i, &fst) == 0)
+					break;
+			if (i == f->filesz)
+				return f;
+		}
+		*fp = f->next;
+		frag_free(f);
+	}
+	return NULL;
+}
+
+/*
+ * Insert a copy of a cached fragment at the current position,
+ * as if the included file had been parsed.
+ */
+static void
+frag_use(struct parse *p, struct frag *f)
+{
+	struct pnode	*n, *nn;
+	size_t		 i;
+
+	nn = NULL;
+	PNODE_FOREACH(n, f->nodes) {
+		nn = pnode_clone(p->tree->arena, p->cur, n);
+		ptree_append(p->tree, nn);
+		if (nn->node == NODE_ENTITY && p->cur == p->doctype)
+			xml_entity_decl(p, nn);
+	}
+	if (f->endtext) {
+		p->cur = nn;
+		p->tlen = strlen(nn->u.b);
+		p->tsz = p->tlen + 1;
+	}
+	p->ncur = f->ncur;
+	for (i = 1; i < f->filesz; i++) {
+		ffile_report(p, f->files + i);
+		if (p->rec != NULL)
+			frag_copyfile(p->rec, f->files + i);
+	}
+}
+
+/*
+ * Start recording the fragment generated at the current position
+ * in the context ctx, by an included file or an entity expansion.
+ */
+static struct frag *
+frag_start(struct parse *p, int ctx, struct fragstate *fs)
+{
+	struct frag	*f;
+
+	f = xcalloc(1, sizeof(*f));
+	f->arena = arena_alloc();
+	f->nodes = pnode_alloc(f->arena, NULL);
+	f->ctx = ctx;
+	fs->cur = p->cur;
+	fs->last = PNODE_LAST(p->cur);
+	fs->doctype = p->doctype;
+	fs->rec = p->rec;
+	fs->taint = p->taint;
+	fs->nref = p->nref;
+	fs->nofill = p->nofill;
+	fs->treeflags = p->tree->flags;
+	p->rec = f;
+	return f;
+}
+
+/*
+ * Stop recording a fragment.  Store a copy of the generated nodes
+ * in the list *head, unless anything happened that depends on more
+ * than the context or that affects other parts of the tree.
+ * Within the document, references to declared entities always
+ * resolve the same way, so entity expansions may contain them,
+ * but they must not read files.
+ */
+static void
+frag_finish(struct parse *p, struct frag *f, const struct fragstate *fs,
+    struct frag **head)
+{
+	struct pnode	*n;
+	size_t		 i;
+	int		 taint;
+
+	p->rec = fs->rec;
+	if (p->rec != NULL)
+		for (i = 0; i < f->filesz; i++)
+			frag_copyfile(p->rec, f->files + i);
+	taint = p->taint - fs->taint;
+	if (f->ctx & FCTX_ENTITY)
+		taint -= p->nref - fs->nref;
+	if (taint || p->del > 0 ||
+	    (f->ctx & FCTX_ENTITY && f->filesz > 0) ||
+	    p->nofill != fs->nofill || p->doctype != fs->doctype ||
+	    p->tree->flags != fs->treeflags ||
+	    p->flags & (PFLAG_ATTR | PFLAG_EEND) || p->cur == NULL ||
+	    (p->cur != fs->cur && (p->cur->node != NODE_TEXT ||
+	     p->cur->parent != fs->cur))) {
+		frag_free(f);
+		return;
+	}
+	n = fs->last == NULL ? PNODE_FIRST(fs->cur) : PNODE_NEXT(fs->last);
+	for (; n != NULL; n = PNODE_NEXT(n))
+		pnode_clone(f->arena, f->nodes, n);
+	f->endtext = p->cur != fs->cur;
+	f->ncur = p->ncur;
+	f->next = *head;
+	*head = f;
+}
+
+/*
+ * Find a snapshot of the entity file path such that none
+ * of the files it read changed since, either in memory
+ * or in the snapshot directory.  Snapshots found to be
+ * out of date on the way are removed from the cache and
+ * freed as soon as no parser uses them any longer.
+ */
+static struct snap *
+pcache_getsnap(struct pcache *c, const char *path)
+{
+	struct snapfile	 sf;
+	struct snap	**sp, *s;
+
+	sp = &c->snaps;
+	while ((s = *sp) != NULL) {
+		snap_file(s, 0, &sf);
+		if (strcmp(sf.path, path) != 0) {
+			sp = &s->next;
+			continue;
+		}
+		if (snap_valid(s))
+			return s;
+		*sp = s->next;
+		if (s->nuse > 0)
+			s->stale = 1;
+		else
+			snap_free(s);
+	}
+	if (c->dir == NULL || (s = snap_load(c->dir, path)) == NULL)
+		return NULL;
+	if (snap_valid(s) == 0) {
+		snap_free(s);
+		return NULL;
+	}
+	s->next = c->snaps;
+	c->snaps = s;
+	return s;
+}
+
+/*
+ * Take the declarations following decl from the snapshot s,
+ * as if the files it read had been parsed.
+ */
+static void
+snap_use(struct parse *p, struct pnode *decl, struct snap *s)
+{
+	struct snapfile	 sf;
+	struct ffile	 ff;
+	size_t		 i;
+
+	if (p->snapsz == p->snapmax) {
+		p->snapmax = p->snapmax == 0 ? 4 : p->snapmax * 2;
+		p->snaps = xreallocarray(p->snaps,
+		    p->snapmax, sizeof(*p->snaps));
+	}
+	p->snaps[p->snapsz].decl = decl;
+	p->snaps[p->snapsz].seq = p->entsz;
+	p->snaps[p->snapsz++].snap = s;
+	s->nuse++;
+	for (i = 0; snap_file(s, i, &sf) == 0; i++) {
+		ff.path = (char *)sf.path;
+		ff.dev = sf.dev;
+		ff.ino = sf.ino;
+		ff.size = sf.size;
+		ff.mtime = sf.mtime;
+		ffile_report(p, &ff);
+		if (p->rec != NULL)
+			frag_copyfile(p->rec, &ff);
+	}
+}
+
+/*
+ * Include the file containing entity declarations named in the
+ * parameter entity declaration decl.  Use a snapshot if possible,
+ * or else parse the file and compile a snapshot for later use,
+ * unless parsing did more than adding entity declarations.
+ */
+static void
+parse_entfile(struct parse *p, struct pnode *decl, const char *fname)
+{
+	struct snapfile	*sf;
+	struct frag	*rec, *save_rec;
+	struct snap	*s;
+	char		*path;
+	size_t		 i;
+	int		 taint;
+
+	if (p->cache == NULL || p->entrec || p->doctype == NULL ||
+	    p->cur != p->doctype ||
+	    PNODE_LAST(p->doctype) != decl) {
+		parse_file(p, -1, fname);
+		return;
+	}
+	path = parse_path(p, fname);
+	if ((s = pcache_getsnap(p->cache, path)) != NULL) {
+		snap_use(p, decl, s);
+		free(path);
+		return;
+	}
+
+	/* Record the files read while parsing. */
+
+	save_rec = p->rec;
+	p->rec = rec = xcalloc(1, sizeof(*rec));
+	taint = p->taint;
+	p->entrec = 1;
+	parse_file(p, -1, fname);
+	p->entrec = 0;
+	p->rec = save_rec;
+
+	if (p->taint == taint && p->del == 0 && p->cur == p->doctype &&
+	    p->ncur == NODE_DOCTYPE && rec->filesz > 0 &&
+	    strcmp(rec->files->path, path) == 0) {
+		sf = xreallocarray(NULL, rec->filesz, sizeof(*sf));
+		for (i = 0; i < rec->filesz; i++) {
+			sf[i].path = rec->files[i].path;
+			sf[i].dev = rec->files[i].dev;
+			sf[i].ino = rec->files[i].ino;
+			sf[i].size = rec->files[i].size;
+			sf[i].mtime = rec->files[i].mtime;
+		}
+		s = snap_build(PNODE_NEXT(decl), sf, rec->filesz);
+		if (s != NULL) {
+			s->next = p->cache->snaps;
+			p->cache->snaps = s;
+			if (p->cache->dir != NULL)
+				snap_save(s, p->cache->dir);
+		}
+		free(sf);
+	}
+	if (save_rec != NULL)
+		for (i = 0; i < rec->filesz; i++)
+			frag_copyfile(save_rec, rec->files + i);
+	frag_free(rec);
+	free(path);
+}
+
 /*
  * Open and parse a file.
  */
 struct ptree *
 parse_file(struct parse *p, int fd, const char *fname)
 {
+	struct fragstate fs;
+	struct stat	 st;
+	struct frag	*f, *rec;
 	const char	*save_fname;
-	int		 save_line, save_col;
+	char		*save_dname, *path;
+	struct ppos	 save_pos;
+	int		 ctx, save_dirfd, stok;
 
 	/* Save and initialize reporting data. */
 
 	save_fname = p->fname;
-	save_line = p->nline;
-	save_col = p->ncol;
+	save_dirfd = p->dirfd;
+	save_dname = p->dname;
+	save_pos = p->pos;
 	p->fname = fname;
-	p->line = 0;
-	p->col = 0;
-
-	/* Open the file, unless it is already open. */
-
-	if (fd == -1 && (fd = open(fname, O_RDONLY, 0)) == -1) {
-		error_msg(p, "open: %s", strerror(errno));
-		p->fname = save_fname;
-		return p->tree;
-	}
+	memset(&p->pos, 0, sizeof(p->pos));
 
 	/*
-	 * After opening the starting file, change to the directory it
-	 * is located in, in case it wants to include any further files,
-	 * which are typically given with relative paths in DocBook.
-	 * Do this on a best-effort basis; don't complain about failure.
+	 * Open the file, unless it is already open.
+	 * Relative file names are relative to the directory
+	 * containing the file that includes them.
 	 */
 
-	if (save_fname == NULL && (fname = dirname(fname)) != NULL &&
-	    strcmp(fname, ".") != 0)
-		(void)chdir(fname);
+	rec = NULL;
+	memset(&fs, 0, sizeof(fs));
+	if (fd == -1) {
+		if ((fd = openat(p->dirfd, fname, O_RDONLY, 0)) == -1)
+			error_msg(p, "open: %s", strerror(errno));
+		path = parse_path(p, fname);
+		if (fd == -1) {
+			if (p->filefunc != NULL)
+				(*p->filefunc)(p->filearg, path, 0, NULL);
+			free(path);
+			p->fname = save_fname;
+			p->pos = save_pos;
+			return p->tree;
+		}
+		stok = fstat(fd, &st) == 0;
+		if (p->filefunc != NULL)
+			(*p->filefunc)(p->filearg, path, 1, stok ? &st : NULL);
 
-	/* Run the read loop. */
+		/*
+		 * For included files, reuse the parse tree
+		 * from the cache if possible, or else try to
+		 * record it for later reuse.
+		 */
 
-	p->nline = 1;
-	p->ncol = 1;
-	parse_fd(p, fd);
+		if (p->cache != NULL) {
+			if (stok == 0)
+				p->taint++;
+			else {
+				if (p->rec != NULL)
+					frag_addfile(p->rec, path, &st);
+				if (save_fname != NULL &&
+				    (ctx = frag_context(p)) != -1) {
+					f = frag_find(p, path, &st, ctx);
+					if (f != NULL) {
+						frag_use(p, f);
+						close(fd);
+						free(path);
+						p->fname = save_fname;
+						p->pos = save_pos;
+						return p->tree;
+					}
+					if (p->rec == NULL) {
+						rec = frag_start(p, ctx, &fs);
+						frag_addfile(rec, path, &st);
+					}
+				}
+			}
+		}
+		free(path);
+	}
+	parse_setdir(p, fname);
 
-	/* On the top level, finalize the parse tree. */
+	/* Run the read loop. */
 
-	if (save_fname == NULL) {
-		pnode_closetext(p, 0);
-		if (p->tree->root == NULL)
-			error_msg(p, "empty document");
-		else if ((p->tree->flags & TREE_CLOSED) == 0)
-			warn_msg(p, "document not closed");
-		pnode_unlink(p->doctype);
-	}
+	parse_fd(p, fd);
+	if (save_fname == NULL)
+		parse_finish(p);
+	else if (rec != NULL)
+		frag_finish(p, rec, &fs, &p->cache->frags);
 
 	/* Clean up. */
 
 	if (fd != STDIN_FILENO)
 		close(fd);
+	parse_resetdir(p, save_dirfd, save_dname);
 	p->fname = save_fname;
-	p->nline = save_line;
-	p->ncol = save_col;
+	p->pos = save_pos;
+	return p->tree;
+}
+
+/*
+ * Parse a complete document of sz bytes from memory.
+ * The name fname is used for messages and for locating
+ * relative names of included files; it is not opened.
+ */
+struct ptree *
+parse_buf(struct parse *p, const char *buf, size_t sz, const char *fname)
+{
+	char		*b, *save_dname;
+	enum pstate	 pstate;
+	int		 save_dirfd;
+
+	save_dirfd = p->dirfd;
+	save_dname = p->dname;
+	p->fname = fname;
+	parse_setdir(p, fname);
+
+	/* The parser needs a writable copy with room for a NUL byte. */
+
+	b = xcalloc(1, sz + 1);
+	memcpy(b, buf, sz);
+	pstate = PARSE_ELEM;
+	ppos_start(&p->pos, b);
+	parse_string(p, b, sz, &pstate, PSTR_TRACK);
+	ppos_stop(&p->pos);
+	free(b);
+	parse_finish(p);
+	parse_resetdir(p, save_dirfd, save_dname);
+	p->fname = NULL;
 	return p->tree;
 }
@@ -20,7 +20,31 @@
  */
 
 struct parse;	 /* Opaque object; used only in parse.c. */
+struct pcache;	 /* Opaque object; used only in parse.c. */
+struct arena;	 /* Opaque object; used only in xmalloc.c. */
+struct stat;
+
+/* Message levels, equal to the corresponding exit status. */
+#define	MSG_WARNING	2
+#define	MSG_ERROR	3
+
+/* Callback receiving file name, line, column, level, and text. */
+typedef void	 pmsg_func(void *, const char *, int, int, int, const char *);
+
+/*
+ * Callback receiving the path of each file, whether it was found,
+ * and its status when it was opened, or NULL if that is unknown.
+ */
+typedef void	 pfile_func(void *, const char *, int, const struct stat *);
 
 struct parse	*parse_alloc(int warn);
+void		 parse_setmsg(struct parse *, pmsg_func *, void *);
+void		 parse_setfile(struct parse *, pfile_func *, void *);
+void		 parse_setcache(struct parse *, struct pcache *);
+void		 parse_setarena(struct parse *, struct arena *);
 void		 parse_free(struct parse *);
 struct ptree	*parse_file(struct parse *, int, const char *);
+struct ptree	*parse_buf(struct parse *, const char *, size_t, const char *);
+
+struct pcache	*pcache_alloc(const char *);
+void		 pcache_free(struct pcache *);
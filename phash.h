@@ -0,0 +1,64 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Perfect hash tables of fixed sets of names, generated by mkhash.
+ */
+
+/*
+ * The first hash of a name selects a bucket, which provides
+ * the seed of a second hash selecting the slot of the name.
+ */
+struct	nametab {
+	const unsigned char  *disp;  /* Seed of each bucket, 0 if empty. */
+	const unsigned short *slot;  /* Table index plus one, or 0. */
+	unsigned int	 dbits;      /* Log2 of the number of buckets. */
+	unsigned int	 sbits;      /* Log2 of the number of slots. */
+};
+
+/*
+ * Hash a name, using FNV-1a with a final mixing step
+ * such that the low bits depend on all input bytes.
+ */
+static unsigned int
+name_hash(const char *name, unsigned int seed)
+{
+	uint32_t	 h;
+
+	h = 2166136261U ^ seed * 0x9e3779b9U;
+	while (*name != '\0')
+		h = (h ^ (unsigned char)*name++) * 16777619U;
+	h ^= h >> 16;
+	h *= 0x85ebca6bU;
+	h ^= h >> 13;
+	return h;
+}
+
+/*
+ * Look up a name in a perfect hash table.  Return the index
+ * of the only entry the name can match, or -1 if there is none.
+ */
+static int
+name_find(const struct nametab *t, const char *name)
+{
+	unsigned int	 d;
+
+	if ((d = t->disp[name_hash(name, 0) &
+	    ((1U << t->dbits) - 1)]) == 0)
+		return -1;
+	return t->slot[name_hash(name, d) & ((1U << t->sbits) - 1)] - 1;
+}
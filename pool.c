@@ -0,0 +1,375 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "xmalloc.h"
+#include "sink.h"
+#include "pool.h"
+
+/*
+ * The implementation of the pool of worker processes.
+ *
+ * Each worker repeatedly reads the next job number from its job pipe,
+ * runs the job function with its standard error output redirected
+ * to a temporary file, and sends the exit status and the collected
+ * messages back through its result pipe, followed by any data the
+ * job function wrote to its sink.  The parent process hands out the
+ * next job whenever a worker sends a result, and closes the job pipe
+ * when no jobs are left.
+ * The parent process prints the messages and passes the data
+ * to the done function in the order of the jobs, such that the output does not depend
+ * on the number of workers.
+ */
+
+struct	job {
+	char		*msg;    /* Messages to print on stderr. */
+	size_t		 len;    /* Length of msg. */
+	char		*data;   /* Data to pass to the done function. */
+	size_t		 datalen; /* Length of data. */
+	int		 rc;     /* Exit status of the job. */
+	int		 done;   /* The result has arrived. */
+};
+
+struct	worker {
+	pid_t		 pid;    /* Process ID or -1 if not running. */
+	int		 fd;     /* Reading end of the result pipe. */
+	int		 cmd;    /* Writing end of the job pipe or -1. */
+	size_t		 job;    /* Job in progress or SIZE_MAX. */
+};
+
+struct	result {
+	size_t		 job;    /* Job number. */
+	size_t		 len;    /* Length of the messages following. */
+	size_t		 datalen; /* Length of the data after the messages. */
+	int		 rc;     /* Exit status. */
+};
+
+
+static int
+read_full(int fd, void *buf, size_t sz)
+{
+	ssize_t		 rsz;
+
+	while (sz > 0) {
+		if ((rsz = read(fd, buf, sz)) == -1) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		if (rsz == 0)
+			return -1;
+		buf = (char *)buf + rsz;
+		sz -= rsz;
+	}
+	return 0;
+}
+
+static int
+write_full(int fd, const void *buf, size_t sz)
+{
+	ssize_t		 wsz;
+
+	while (sz > 0) {
+		if ((wsz = write(fd, buf, sz)) == -1) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		buf = (const char *)buf + wsz;
+		sz -= wsz;
+	}
+	return 0;
+}
+
+/*
+ * The main loop of one worker process; never returns.
+ */
+static void
+pool_work(int cmd, int fd, pool_func *func, void *arg, int wantdata)
+{
+	struct result	 res;
+	struct sink	 data;
+	char		 buf[BUFSIZ];
+	FILE		*tmp;
+	off_t		 off, pos;
+	ssize_t		 rsz;
+
+	if ((tmp = tmpfile()) == NULL) {
+		perror("tmpfile");
+		_exit(6);
+	}
+	dup2(fileno(tmp), STDERR_FILENO);
+	while (read_full(cmd, &res.job, sizeof(res.job)) == 0) {
+		sink_init_buf(&data);
+		res.rc = (*func)(res.job, arg, wantdata ? &data : NULL);
+		fflush(stdout);
+		fflush(stderr);
+		if ((off = lseek(STDERR_FILENO, 0, SEEK_CUR)) == -1)
+			off = 0;
+		res.len = off;
+		res.datalen = data.len;
+		if (write_full(fd, &res, sizeof(res)) == -1)
+			_exit(6);
+		for (pos = 0; pos < off; pos += rsz) {
+			rsz = pread(STDERR_FILENO, buf,
+			    off - pos < (off_t)sizeof(buf) ?
+			    (size_t)(off - pos) : sizeof(buf), pos);
+			if (rsz <= 0)
+				_exit(6);
+			if (write_full(fd, buf, rsz) == -1)
+				_exit(6);
+		}
+		if (write_full(fd, data.b, data.len) == -1)
+			_exit(6);
+		sink_free(&data);
+		ftruncate(STDERR_FILENO, 0);
+		lseek(STDERR_FILENO, 0, SEEK_SET);
+	}
+	_exit(0);
+}
+
+/*
+ * Send the next job to the worker w, or tell it to exit
+ * by closing its job pipe if there are no more jobs.
+ */
+static void
+pool_next(struct worker *w, size_t *next, size_t njobs)
+{
+	w->job = SIZE_MAX;
+	if (w->cmd == -1)
+		return;
+	if (*next < njobs && write_full(w->cmd, next, sizeof(*next)) == 0) {
+		w->job = (*next)++;
+		return;
+	}
+	close(w->cmd);
+	w->cmd = -1;
+}
+
+/*
+ * Start the worker w and give it its first job.  The new process
+ * closes the pipes of the other workers, such that each worker
+ * sees the end of its job pipe as soon as the parent closes it.
+ */
+static int
+pool_spawn(struct worker *workers, int nworkers, struct worker *w,
+    size_t *next, size_t njobs, pool_func *func, void *arg, int wantdata)
+{
+	int		 cmds[2], fds[2], i;
+
+	w->pid = -1;
+	w->job = SIZE_MAX;
+	if (pipe(cmds) == -1) {
+		perror("pipe");
+		return -1;
+	}
+	if (pipe(fds) == -1) {
+		perror("pipe");
+		close(cmds[0]);
+		close(cmds[1]);
+		return -1;
+	}
+	fflush(stdout);
+	fflush(stderr);
+	if ((w->pid = fork()) == -1) {
+		perror("fork");
+		close(cmds[0]);
+		close(cmds[1]);
+		close(fds[0]);
+		close(fds[1]);
+		return -1;
+	}
+	if (w->pid == 0) {
+		signal(SIGPIPE, SIG_DFL);
+		for (i = 0; i < nworkers; i++) {
+			if (workers[i].pid > 0) {
+				close(workers[i].fd);
+				if (workers[i].cmd != -1)
+					close(workers[i].cmd);
+			}
+		}
+		close(cmds[1]);
+		close(fds[0]);
+		pool_work(cmds[0], fds[1], func, arg, wantdata);
+	}
+	close(cmds[0]);
+	close(fds[1]);
+	w->cmd = cmds[1];
+	w->fd = fds[0];
+	pool_next(w, next, njobs);
+	return 0;
+}
+
+/*
+ * Run njobs calls of func, using up to nworkers processes in parallel.
+ * Messages from each job are printed in order of the jobs,
+ * and names[] is used for reporting jobs that aborted.
+ * Unless done is NULL, each job gets its own memory sink,
+ * and its contents are passed to done, again in order of the jobs.
+ * Return the highest exit status of any of the jobs
+ * and of the calls to done.
+ */
+int
+pool_run(int nworkers, size_t njobs, char *const *names,
+    pool_func *func, pool_done_func *done, void *arg)
+{
+	struct result	 res;
+	struct job	*jobs, *j;
+	struct worker	*workers, *w;
+	struct pollfd	*pfds;
+	void		(*sigpipe)(int);
+	size_t		 next, printed;
+	int		 i, nrun, rc, rc1, status;
+
+	if ((size_t)nworkers > njobs)
+		nworkers = njobs;
+	next = 0;
+	jobs = xcalloc(njobs, sizeof(*jobs));
+	workers = xcalloc(nworkers, sizeof(*workers));
+	pfds = xcalloc(nworkers, sizeof(*pfds));
+
+	/* A worker may die before reading the job sent to it. */
+
+	sigpipe = signal(SIGPIPE, SIG_IGN);
+
+	nrun = 0;
+	for (i = 0; i < nworkers; i++)
+		workers[i].pid = -1;
+	for (i = 0; i < nworkers; i++)
+		if (pool_spawn(workers, nworkers, workers + i, &next, njobs,
+		    func, arg, done != NULL) == 0)
+			nrun++;
+
+	rc = 0;
+	printed = 0;
+	while (nrun > 0) {
+		for (i = 0; i < nworkers; i++) {
+			w = workers + i;
+			pfds[i].fd = w->pid == -1 ? -1 : w->fd;
+			pfds[i].events = POLLIN;
+		}
+		if (poll(pfds, nworkers, -1) == -1) {
+			if (errno == EINTR)
+				continue;
+			perror("poll");
+			break;
+		}
+		for (i = 0; i < nworkers; i++) {
+			if (pfds[i].revents == 0)
+				continue;
+			w = workers + i;
+
+			/* Collect one result record. */
+
+			if (read_full(w->fd, &res, sizeof(res)) == 0 &&
+			    res.job == w->job) {
+				j = jobs + res.job;
+				j->msg = xcalloc(1, res.len + 1);
+				j->data = xcalloc(1, res.datalen + 1);
+				if (read_full(w->fd, j->msg, res.len) == 0 &&
+				    read_full(w->fd, j->data,
+				     res.datalen) == 0) {
+					j->len = res.len;
+					j->datalen = res.datalen;
+					j->rc = res.rc;
+					j->done = 1;
+					pool_next(w, &next, njobs);
+					continue;
+				}
+			}
+
+			/*
+			 * The worker exited; if it died while working
+			 * on a job, report that job as aborted.
+			 * Replace the worker if jobs remain.
+			 */
+
+			close(w->fd);
+			if (w->cmd != -1)
+				close(w->cmd);
+			waitpid(w->pid, &status, 0);
+			w->pid = -1;
+			nrun--;
+			if (w->job != SIZE_MAX) {
+				j = jobs + w->job;
+				free(j->msg);
+				free(j->data);
+				j->data = NULL;
+				j->datalen = 0;
+				j->len = xasprintf(&j->msg,
+				    "%s: Conversion aborted\n", names[w->job]);
+				j->rc = WIFEXITED(status) &&
+				    WEXITSTATUS(status) > 3 ?
+				    WEXITSTATUS(status) : 3;
+				j->done = 1;
+			}
+			if (next < njobs && pool_spawn(workers, nworkers, w,
+			    &next, njobs, func, arg, done != NULL) == 0)
+				nrun++;
+		}
+
+		/* Print messages in order, as far as available. */
+
+		while (printed < njobs && jobs[printed].done) {
+			j = jobs + printed;
+			fwrite(j->msg, 1, j->len, stderr);
+			if (done != NULL && (rc1 = (*done)(printed, arg,
+			    j->data, j->datalen)) > j->rc)
+				j->rc = rc1;
+			if (j->rc > rc)
+				rc = j->rc;
+			printed++;
+			free(j->msg);
+			free(j->data);
+		}
+	}
+	fflush(stderr);
+
+	/* Jobs that were never run, for example because fork failed. */
+
+	for (; printed < njobs; printed++) {
+		j = jobs + printed;
+		if (j->done) {
+			fwrite(j->msg, 1, j->len, stderr);
+			if (done != NULL && (rc1 = (*done)(printed, arg,
+			    j->data, j->datalen)) > j->rc)
+				j->rc = rc1;
+			if (j->rc > rc)
+				rc = j->rc;
+		} else {
+			fprintf(stderr, "%s: Not converted\n", names[printed]);
+			rc = 6;
+		}
+		free(j->msg);
+		free(j->data);
+	}
+	free(pfds);
+	free(workers);
+	free(jobs);
+	signal(SIGPIPE, sigpipe);
+	return rc;
+}
@@ -0,0 +1,35 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * The interface of the pool of worker processes.
+ */
+
+struct sink;
+
+/* Job function receiving the job number, an argument, and a sink. */
+typedef int	 pool_func(size_t, void *, struct sink *);
+
+/*
+ * Function receiving the job number, the argument, and the data
+ * written to the sink of the job, or NULL if the job aborted.
+ * It returns an exit status to account for.
+ */
+typedef int	 pool_done_func(size_t, void *, const char *, size_t);
+
+int	 pool_run(int, size_t, char *const *, pool_func *,
+		pool_done_func *, void *);
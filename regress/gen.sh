@@ -0,0 +1,76 @@
+#!/bin/sh
+# $Id$
+#
+# Generate a document for the regression suite containing a single
+# token or text run of the given size in bytes, or with -o, the
+# mdoc(7) output expected when converting it from the file name.xml.
+#
+# usage: gen.sh [-o] name size
+# names: attr comment word text screen
+
+out=0
+if [ "$1" = -o ]; then
+	out=1
+	shift
+fi
+if [ $# -ne 2 ]; then
+	echo "usage: gen.sh [-o] name size" >&2
+	exit 1
+fi
+
+exec awk -v out="$out" -v name="$1" -v size="$2" '
+
+# Repeat the string s up to a length of n bytes,
+# doubling it such that generating it takes linear time.
+function rep(s, n,  r) {
+	r = s
+	while (length(r) < n)
+		r = r r
+	return substr(r, 1, n)
+}
+
+# Repeat the line s, which ends in a newline,
+# as often as it fits into n bytes.
+function lines(s, n) {
+	return rep(s, n - n % length(s))
+}
+
+BEGIN {
+	if (name == "attr") {
+		body = "<para role=\"" rep("attrvalue", size) "\">" \
+		    "attribute</para>"
+		expect = "attribute\n"
+	} else if (name == "comment") {
+		body = "<!--" rep(" comment text", size) " -->" \
+		    "<para>comment</para>"
+		expect = "comment\n"
+	} else if (name == "word") {
+		body = "<para>" rep("abcdefghij", size) "</para>"
+		expect = rep("abcdefghij", size) "\n"
+	} else if (name == "text") {
+		body = "<para>\n" lines("Some words.\n", size) "</para>"
+		expect = lines("Some words.\n", size)
+	} else if (name == "screen") {
+		body = "<screen>" lines("line of literal text\n", size) \
+		    "</screen>"
+		expect = ".Bd -literal\n" \
+		    lines("line of literal text\n", size) ".Ed\n"
+	} else {
+		print "gen.sh: unknown name: " name > "/dev/stderr"
+		exit 1
+	}
+	if (out)
+		printf ".\\\" automatically generated with " \
+		    "docbook2mdoc %s.xml\n" \
+		    ".Dd $Mdocdate$\n.Dt HUGE 1\n.Os\n" \
+		    ".Sh NAME\n.Nm huge\n.Nd %s\n" \
+		    ".Sh DESCRIPTION\n%s", name, name, expect
+	else
+		printf "<refentry><refmeta>" \
+		    "<refentrytitle>huge</refentrytitle>" \
+		    "<manvolnum>1</manvolnum></refmeta>\n" \
+		    "<refnamediv><refname>huge</refname>" \
+		    "<refpurpose>%s</refpurpose></refnamediv>\n" \
+		    "<refsection><title>DESCRIPTION</title>\n" \
+		    "%s\n</refsection></refentry>\n", name, body
+}'
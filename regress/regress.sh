@@ -0,0 +1,45 @@
+#!/bin/sh
+# $Id$
+#
+# Convert documents containing huge tokens and text runs
+# and compare the output to the expected output.
+# Each conversion runs with a limit on CPU time that a parser
+# rescanning incomplete tokens after every refill of the read
+# buffer would exceed, so passing shows linear run time.
+#
+# usage: regress.sh [docbook2mdoc]
+
+bin=${1:-./docbook2mdoc}
+size=33554432	# Size of each token in bytes.
+limit=5		# CPU time per conversion in seconds.
+gen=$(dirname "$0")/gen.sh
+
+case $bin in
+/*)	;;
+*)	bin=$(pwd)/$bin ;;
+esac
+tmp=$(mktemp -d "${TMPDIR:-/tmp}/regress.XXXXXXXXXX") || exit 1
+trap 'rm -rf "$tmp"' 0
+
+fail=0
+for name in attr comment word text screen; do
+	sh "$gen" "$name" $size >"$tmp/$name.xml"
+	sh "$gen" -o "$name" $size >"$tmp/$name.expect"
+	(cd "$tmp" && ulimit -t $limit &&
+	    "$bin" "$name.xml" >"$name.out" 2>"$name.err")
+	rc=$?
+	if [ $rc -ne 0 ]; then
+		echo "FAIL $name: exit status $rc"
+		fail=1
+	elif [ -s "$tmp/$name.err" ]; then
+		echo "FAIL $name: unexpected messages"
+		head -n 5 "$tmp/$name.err"
+		fail=1
+	elif ! cmp -s "$tmp/$name.expect" "$tmp/$name.out"; then
+		echo "FAIL $name: output differs"
+		fail=1
+	else
+		echo "ok $name"
+	fi
+done
+exit $fail
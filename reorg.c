@@ -24,60 +24,62 @@
  */
 
 static void
-reorg_root(struct pnode *root, const char *sec)
+reorg_root(struct ptree *t, struct pnode *root, const char *sec)
 {
 	struct pnode	*date, *info, *name, *vol, *nc;
+	const char	*title;
 
 	if (root == NULL)
 		return;
 
 	/* Collect prologue information. */
 
-	if ((date = pnode_takefirst(root, NODE_PUBDATE)) == NULL &&
-	    (date = pnode_takefirst(root, NODE_DATE)) == NULL) {
-		date = pnode_alloc(NULL);
-		pnode_alloc_text(date, "$Mdocdate" "$");
+	if ((date = ptree_takefirst(t, root, NODE_PUBDATE)) == NULL &&
+	    (date = ptree_takefirst(t, root, NODE_DATE)) == NULL) {
+		date = pnode_alloc(t->arena, NULL);
+		pnode_alloc_text(t->arena, date, "$Mdocdate" "$");
 	}
-	date->node = NODE_DATE;
-	date->parent = root;
+	pnode_settype(date, NODE_DATE);
 
 	name = vol = NULL;
-	if ((nc = pnode_findfirst(root, NODE_REFMETA)) != NULL) {
-		name = pnode_takefirst(nc, NODE_REFENTRYTITLE);
-		vol = pnode_takefirst(nc, NODE_MANVOLNUM);
+	if ((nc = ptree_findfirst(t, root, NODE_REFMETA)) != NULL) {
+		name = ptree_takefirst(t, nc, NODE_REFENTRYTITLE);
+		vol = ptree_takefirst(t, nc, NODE_MANVOLNUM);
 	}
 	if (name == NULL) {
-		name = pnode_alloc(NULL);
-		name->node = NODE_REFENTRYTITLE;
-		name->parent = root;
-		pnode_alloc_text(name,
-		    pnode_getattr_raw(root, ATTRKEY_ID, "UNKNOWN"));
+		name = pnode_alloc(t->arena, NULL);
+		pnode_settype(name, NODE_REFENTRYTITLE);
+		if ((title = pnode_getattr_raw(root,
+		    ATTRKEY_ID, NULL)) == NULL) {
+			title = "UNKNOWN";
+			t->flags |= TREE_NOTITLE;
+		}
+		pnode_alloc_text(t->arena, name, title);
 	}
 	if (vol == NULL || sec != NULL) {
 		pnode_unlink(vol);
-		vol = pnode_alloc(NULL);
-		vol->node = NODE_MANVOLNUM;
-		vol->parent = root;
-		pnode_alloc_text(vol, sec == NULL ? "1" : sec);
+		vol = pnode_alloc(t->arena, NULL);
+		pnode_settype(vol, NODE_MANVOLNUM);
+		pnode_alloc_text(t->arena, vol, sec == NULL ? "1" : sec);
 	}
 
 	/* Insert prologue information at the beginning. */
 
-	if (pnode_findfirst(root, NODE_REFNAMEDIV) == NULL &&
-	    ((info = pnode_findfirst(root, NODE_BOOKINFO)) != NULL ||
-	     (info = pnode_findfirst(root, NODE_REFENTRYINFO)) != NULL)) {
-		if ((nc = pnode_takefirst(info, NODE_ABSTRACT)) != NULL)
-			TAILQ_INSERT_HEAD(&root->childq, nc, child);
-		if ((nc = pnode_takefirst(info, NODE_TITLE)) != NULL)
-			TAILQ_INSERT_HEAD(&root->childq, nc, child);
+	if (ptree_findfirst(t, root, NODE_REFNAMEDIV) == NULL &&
+	    ((info = ptree_findfirst(t, root, NODE_BOOKINFO)) != NULL ||
+	     (info = ptree_findfirst(t, root, NODE_REFENTRYINFO)) != NULL)) {
+		if ((nc = ptree_takefirst(t, info, NODE_ABSTRACT)) != NULL)
+			ptree_insert(t, root, nc, PNODE_FIRST(root));
+		if ((nc = ptree_takefirst(t, info, NODE_TITLE)) != NULL)
+			ptree_insert(t, root, nc, PNODE_FIRST(root));
 	}
-	TAILQ_INSERT_HEAD(&root->childq, vol, child);
-	TAILQ_INSERT_HEAD(&root->childq, name, child);
-	TAILQ_INSERT_HEAD(&root->childq, date, child);
+	ptree_insert(t, root, vol, PNODE_FIRST(root));
+	ptree_insert(t, root, name, PNODE_FIRST(root));
+	ptree_insert(t, root, date, PNODE_FIRST(root));
 }
 
 static void
-reorg_refentry(struct pnode *n)
+reorg_refentry(struct ptree *t, struct pnode *n)
 {
 	struct pnode	*info, *meta, *nc, *title;
 	struct pnode	*match, *later;
@@ -85,21 +87,21 @@ reorg_refentry(struct pnode *n)
 	/* Collect nodes that remained behind from the prologue. */
 
 	meta = NULL;
-	info = pnode_takefirst(n, NODE_BOOKINFO);
-	if (info != NULL && TAILQ_FIRST(&info->childq) == NULL) {
+	info = ptree_takefirst(t, n, NODE_BOOKINFO);
+	if (info != NULL && PNODE_FIRST(info) == NULL) {
 		pnode_unlink(info);
 		info = NULL;
 	}
 	if (info == NULL) {
-		info = pnode_takefirst(n, NODE_REFENTRYINFO);
-		if (info != NULL && TAILQ_FIRST(&info->childq) == NULL) {
+		info = ptree_takefirst(t, n, NODE_REFENTRYINFO);
+		if (info != NULL && PNODE_FIRST(info) == NULL) {
 			pnode_unlink(info);
 			info = NULL;
 		}
 		if (info == NULL)
-			info = pnode_takefirst(n, NODE_INFO);
-		meta = pnode_takefirst(n, NODE_REFMETA);
-		if (meta != NULL && TAILQ_FIRST(&meta->childq) == NULL) {
+			info = ptree_takefirst(t, n, NODE_INFO);
+		meta = ptree_takefirst(t, n, NODE_REFMETA);
+		if (meta != NULL && PNODE_FIRST(meta) == NULL) {
 			pnode_unlink(meta);
 			meta = NULL;
 		}
@@ -117,7 +119,7 @@ reorg_refentry(struct pnode *n)
 	 */
 
 	match = later = NULL;
-	TAILQ_FOREACH(nc, &n->childq, child) {
+	PNODE_FOREACH(nc, n) {
 		switch (nc->node) {
 		case NODE_REFENTRY:
 		case NODE_REFNAMEDIV:
@@ -133,28 +135,28 @@ reorg_refentry(struct pnode *n)
 			break;
 		}
 		if ((title = pnode_findfirst(nc, NODE_TITLE)) == NULL ||
-		    (title = TAILQ_FIRST(&title->childq)) == NULL ||
+		    (title = PNODE_FIRST(title)) == NULL ||
 		    title->node != NODE_TEXT)
 			continue;
-		if (strcasecmp(title->b, "AUTHORS") == 0 ||
-		    strcasecmp(title->b, "AUTHOR") == 0)
+		if (strcasecmp(title->u.b, "AUTHORS") == 0 ||
+		    strcasecmp(title->u.b, "AUTHOR") == 0)
 			match = nc;
-		else if (strcasecmp(title->b, "NAME") == 0 ||
-		    strcasecmp(title->b, "SYNOPSIS") == 0 ||
-		    strcasecmp(title->b, "DESCRIPTION") == 0 ||
-		    strcasecmp(title->b, "RETURN VALUES") == 0 ||
-		    strcasecmp(title->b, "ENVIRONMENT") == 0 ||
-		    strcasecmp(title->b, "FILES") == 0 ||
-		    strcasecmp(title->b, "EXIT STATUS") == 0 ||
-		    strcasecmp(title->b, "EXAMPLES") == 0 ||
-		    strcasecmp(title->b, "DIAGNOSTICS") == 0 ||
-		    strcasecmp(title->b, "ERRORS") == 0 ||
-		    strcasecmp(title->b, "SEE ALSO") == 0 ||
-		    strcasecmp(title->b, "STANDARDS") == 0 ||
-		    strcasecmp(title->b, "HISTORY") == 0)
+		else if (strcasecmp(title->u.b, "NAME") == 0 ||
+		    strcasecmp(title->u.b, "SYNOPSIS") == 0 ||
+		    strcasecmp(title->u.b, "DESCRIPTION") == 0 ||
+		    strcasecmp(title->u.b, "RETURN VALUES") == 0 ||
+		    strcasecmp(title->u.b, "ENVIRONMENT") == 0 ||
+		    strcasecmp(title->u.b, "FILES") == 0 ||
+		    strcasecmp(title->u.b, "EXIT STATUS") == 0 ||
+		    strcasecmp(title->u.b, "EXAMPLES") == 0 ||
+		    strcasecmp(title->u.b, "DIAGNOSTICS") == 0 ||
+		    strcasecmp(title->u.b, "ERRORS") == 0 ||
+		    strcasecmp(title->u.b, "SEE ALSO") == 0 ||
+		    strcasecmp(title->u.b, "STANDARDS") == 0 ||
+		    strcasecmp(title->u.b, "HISTORY") == 0)
 			later = NULL;
-		else if ((strcasecmp(title->b, "CAVEATS") == 0 ||
-		    strcasecmp(title->b, "BUGS") == 0) &&
+		else if ((strcasecmp(title->u.b, "CAVEATS") == 0 ||
+		    strcasecmp(title->u.b, "BUGS") == 0) &&
 		    later == NULL)
 			later = nc;
 	}
@@ -169,19 +171,18 @@ reorg_refentry(struct pnode *n)
 	 */
 
 	if (match == NULL) {
-		match = pnode_alloc(NULL);
-		match->node = NODE_SECTION;
+		match = pnode_alloc(t->arena, NULL);
+		pnode_settype(match, NODE_SECTION);
 		match->flags |= NFLAG_SPC;
-		match->parent = n;
-		nc = pnode_alloc(match);
-		nc->node = NODE_TITLE;
+		nc = pnode_alloc(t->arena, match);
+		pnode_settype(nc, NODE_TITLE);
 		nc->flags |= NFLAG_SPC;
-		nc = pnode_alloc_text(nc, "AUTHORS");
+		nc = pnode_alloc_text(t->arena, nc, "AUTHORS");
 		nc->flags |= NFLAG_SPC;
 		if (later == NULL)
-			TAILQ_INSERT_TAIL(&n->childq, match, child);
+			ptree_insert(t, n, match, NULL);
 		else
-			TAILQ_INSERT_BEFORE(later, match, child);
+			ptree_insert(t, n, match, later);
 	}
 
 	/*
@@ -190,29 +191,28 @@ reorg_refentry(struct pnode *n)
 	 */
 
 	if (info != NULL)
-		TAILQ_INSERT_TAIL(&match->childq, info, child);
+		ptree_insert(t, match, info, NULL);
 	if (meta != NULL)
-		TAILQ_INSERT_TAIL(&match->childq, meta, child);
+		ptree_insert(t, match, meta, NULL);
 #endif
 }
 
 static void
-default_title(struct pnode *n, const char *title)
+default_title(struct ptree *t, struct pnode *n, const char *title)
 {
 	struct pnode	*nc;
 
 	if (n->parent == NULL)
 		return;
 
-	TAILQ_FOREACH(nc, &n->childq, child)
+	PNODE_FOREACH(nc, n)
 		if (nc->node == NODE_TITLE)
 			return;
 
-	nc = pnode_alloc(NULL);
-	nc->node = NODE_TITLE;
-	nc->parent = n;
-	TAILQ_INSERT_HEAD(&n->childq, nc, child);
-	pnode_alloc_text(nc, title);
+	nc = pnode_alloc(t->arena, NULL);
+	pnode_settype(nc, NODE_TITLE);
+	pnode_alloc_text(t->arena, nc, title);
+	ptree_insert(t, n, nc, PNODE_FIRST(n));
 }
 
 static void
@@ -221,16 +221,16 @@ reorg_function(struct pnode *n)
 	struct pnode	*nc;
 	size_t		 sz;
 
-	if ((nc = TAILQ_FIRST(&n->childq)) != NULL &&
+	if ((nc = PNODE_FIRST(n)) != NULL &&
 	    nc->node == NODE_TEXT &&
-	    TAILQ_NEXT(nc, child) == NULL &&
-	    (sz = strlen(nc->b)) > 2 &&
-	    nc->b[sz - 2] == '(' && nc->b[sz - 1] == ')')
-		nc->b[sz - 2] = '\0';
+	    PNODE_NEXT(nc) == NULL &&
+	    (sz = strlen(nc->u.b)) > 2 &&
+	    nc->u.b[sz - 2] == '(' && nc->u.b[sz - 1] == ')')
+		nc->u.b[sz - 2] = '\0';
 }
 
 static void
-reorg_recurse(struct pnode *n)
+reorg_recurse(struct ptree *t, struct pnode *n)
 {
 	struct pnode	*nc;
 
@@ -239,63 +239,64 @@ reorg_recurse(struct pnode *n)
 
 	switch (n->node) {
 	case NODE_ABSTRACT:
-		default_title(n, "Abstract");
-		n->node = NODE_SECTION;
+		default_title(t, n, "Abstract");
+		ptree_settype(t, n, NODE_SECTION);
 		break;
 	case NODE_APPENDIX:
 		if (n->parent == NULL)
-			reorg_refentry(n);
-		default_title(n, "Appendix");
+			reorg_refentry(t, n);
+		default_title(t, n, "Appendix");
 		break;
 	case NODE_CAUTION:
-		default_title(n, "Caution");
-		n->node = NODE_NOTE;
+		default_title(t, n, "Caution");
+		ptree_settype(t, n, NODE_NOTE);
 		break;
 	case NODE_FUNCTION:
 		reorg_function(n);
 		break;
 	case NODE_LEGALNOTICE:
-		default_title(n, "Legal Notice");
-		n->node = NODE_SIMPLESECT;
+		default_title(t, n, "Legal Notice");
+		ptree_settype(t, n, NODE_SIMPLESECT);
 		break;
 	case NODE_NOTE:
-		default_title(n, "Note");
+		default_title(t, n, "Note");
 		break;
 	case NODE_PREFACE:
 		if (n->parent == NULL)
-			reorg_refentry(n);
-		default_title(n, "Preface");
-		n->node = NODE_SECTION;
+			reorg_refentry(t, n);
+		default_title(t, n, "Preface");
+		ptree_settype(t, n, NODE_SECTION);
 		break;
 	case NODE_REFENTRY:
-		reorg_refentry(n);
+		reorg_refentry(t, n);
 		break;
 	case NODE_SECTION:
 		if (n->parent == NULL)
-			reorg_refentry(n);
+			reorg_refentry(t, n);
 		/* FALLTHROUGH */
 	case NODE_SIMPLESECT:
-		default_title(n, "Untitled");
+		default_title(t, n, "Untitled");
 		break;
 	case NODE_TIP:
-		default_title(n, "Tip");
-		n->node = NODE_NOTE;
+		default_title(t, n, "Tip");
+		ptree_settype(t, n, NODE_NOTE);
 		break;
 	case NODE_WARNING:
-		default_title(n, "Warning");
-		n->node = NODE_NOTE;
+		default_title(t, n, "Warning");
+		ptree_settype(t, n, NODE_NOTE);
 		break;
 	default:
 		break;
 	}
 
-	TAILQ_FOREACH(nc, &n->childq, child)
-		reorg_recurse(nc);
+	PNODE_FOREACH(nc, n)
+		reorg_recurse(t, nc);
 }
 
 void
 ptree_reorg(struct ptree *tree, const char *sec)
 {
-	reorg_root(tree->root, sec);
-	reorg_recurse(tree->root);
+	reorg_root(tree, tree->root, sec);
+	reorg_recurse(tree, tree->root);
+	ptree_check(tree);
 }
@@ -0,0 +1,463 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "xmalloc.h"
+#include "sink.h"
+#include "docbook2mdoc.h"
+#include "server.h"
+
+/*
+ * The implementation of the conversion server.
+ *
+ * Requests and responses consist of header lines of the form
+ * "key value", terminated by an empty line, and followed by
+ * as many bytes of data as announced in the header.
+ * A client can send any number of requests over one connection,
+ * each answered by one response, in order.
+ */
+
+#define	HDR_MAX	 8192		/* Longest request header accepted. */
+#define	DATA_MAX (64 * 1024 * 1024) /* Longest document accepted. */
+
+struct	request {
+	char		*file;   /* Input file name or NULL. */
+	char		*name;   /* Name of an inline document or NULL. */
+	char		*data;   /* Inline document or NULL. */
+	size_t		 datasz; /* Length of the inline document. */
+	char		*sec;    /* Manual section or NULL. */
+	int		 outt;   /* D2M_MDOC, D2M_TREE, or -1 for lint. */
+	int		 warn;   /* Report warnings, too. */
+};
+
+struct	conn {
+	int		 ifd;    /* Input file descriptor. */
+	int		 ofd;    /* Output file descriptor. */
+	char		*b;      /* Input not yet handled. */
+	size_t		 len;    /* Number of bytes in b. */
+	size_t		 sz;     /* Allocated size of b. */
+	struct sink	 out;    /* Responses not yet sent. */
+	size_t		 off;    /* Number of bytes of out already sent. */
+	int		 eof;    /* No more input is expected. */
+	int		 rc;     /* Exit status of the connection. */
+};
+
+
+static void
+request_free(struct request *req)
+{
+	free(req->file);
+	free(req->name);
+	free(req->data);
+	free(req->sec);
+}
+
+/*
+ * Parse one request from the first len bytes of b.
+ * Return the number of bytes used, 0 if the request is not
+ * complete yet, or -1 if the input is malformed.  Complaints
+ * about bad header lines are added to msgs, to be sent back
+ * in the response, and so are documents longer than DATA_MAX,
+ * which are rejected before they are received.
+ */
+static ssize_t
+request_parse(const char *b, size_t len, struct request *req,
+    struct sink *msgs)
+{
+	const char	*p, *eol, *next, *errstr;
+	char		*line, *val;
+	long long	 datasz;
+	int		 havelen;
+
+	memset(req, 0, sizeof(*req));
+	req->outt = D2M_MDOC;
+
+	/* Do not look at the header before it is complete. */
+
+	for (p = b;; p = eol + 1) {
+		if ((eol = memchr(p, '\n', len - (p - b))) == NULL)
+			return len > HDR_MAX ? -1 : 0;
+		if (eol == p)
+			break;
+	}
+	if (eol - b > HDR_MAX)
+		return -1;
+
+	havelen = 0;
+	for (p = b; p < eol; p = next + 1) {
+		next = memchr(p, '\n', eol - p);
+		line = xstrndup(p, next - p);
+		if ((val = strchr(line, ' ')) != NULL)
+			*val++ = '\0';
+		else
+			val = line + strlen(line);
+		if (strcmp(line, "file") == 0) {
+			free(req->file);
+			req->file = xstrdup(val);
+		} else if (strcmp(line, "name") == 0) {
+			free(req->name);
+			req->name = xstrdup(val);
+		} else if (strcmp(line, "length") == 0) {
+			datasz = strtonum(val, 0, LLONG_MAX, &errstr);
+			if (errstr == NULL ? datasz > DATA_MAX :
+			    strcmp(errstr, "too large") == 0) {
+				sink_printf(msgs, "%s: Document too long, "
+				    "at most %d bytes allowed\n",
+				    val, DATA_MAX);
+				errstr = "too large";
+			}
+			if (errstr != NULL) {
+				free(line);
+				return -1;
+			}
+			req->datasz = datasz;
+			havelen = 1;
+		} else if (strcmp(line, "section") == 0) {
+			free(req->sec);
+			req->sec = xstrdup(val);
+		} else if (strcmp(line, "type") == 0) {
+			if (strcmp(val, "mdoc") == 0)
+				req->outt = D2M_MDOC;
+			else if (strcmp(val, "tree") == 0)
+				req->outt = D2M_TREE;
+			else if (strcmp(val, "lint") == 0)
+				req->outt = -1;
+			else
+				sink_printf(msgs, "%s: Bad argument\n", val);
+		} else if (strcmp(line, "warn") == 0)
+			req->warn = 1;
+		else
+			sink_printf(msgs, "%s: Bad request header\n", line);
+		free(line);
+	}
+	p = eol + 1;
+	if (havelen) {
+		if (len - (p - b) < req->datasz)
+			return 0;
+		req->data = xcalloc(1, req->datasz + 1);
+		memcpy(req->data, p, req->datasz);
+		p += req->datasz;
+	}
+	if (req->file == NULL && req->data == NULL)
+		sink_printf(msgs, "Request without file or length\n");
+	return p - b;
+}
+
+/*
+ * Convert the document given in one request.
+ * Return the exit status docbook2mdoc(1) would use.
+ */
+static int
+request_run(struct d2m_cache *cache, struct request *req,
+    char **out, size_t *outsz, struct sink *msgs)
+{
+	struct d2m_doc		*doc;
+	const struct d2m_msg	*msg;
+	size_t			 i, nmsg;
+	int			 flags, rc;
+
+	flags = req->warn ? D2M_WARN : 0;
+	doc = req->data != NULL ?
+	    d2m_parse(cache, req->data, req->datasz, req->name, flags) :
+	    d2m_parse_file(cache, req->file, flags);
+	d2m_reorg(doc, req->sec);
+	if (req->outt != -1)
+		*out = d2m_render(doc, req->outt, outsz);
+	msg = d2m_msgs(doc, &nmsg);
+	for (i = 0; i < nmsg; i++, msg++)
+		sink_printf(msgs, "%s:%d:%d: %s: %s\n", msg->fname,
+		    msg->line, msg->col, msg->level == D2M_ERROR ?
+		    "ERROR" : "WARNING", msg->text);
+	rc = d2m_status(doc);
+	d2m_free(doc);
+	return rc;
+}
+
+/*
+ * Queue a response in c->out.
+ */
+static void
+conn_respond(struct conn *c, int rc, const char *output, size_t outsz,
+    const struct sink *msgs)
+{
+	sink_printf(&c->out, "status %d\noutput %zu\nmessages %zu\n\n",
+	    rc, outsz, msgs->len);
+	if (outsz > 0)
+		sink_write(&c->out, output, outsz);
+	if (msgs->len > 0)
+		sink_write(&c->out, msgs->b, msgs->len);
+}
+
+/*
+ * Answer the first request received on c, if it is complete.
+ * The response is queued in c->out.  If the input is malformed,
+ * the rest of it is discarded and the connection is shut down,
+ * after sending an error response if the reason is known.
+ */
+static void
+conn_serve(struct conn *c, struct d2m_cache *cache)
+{
+	struct request	 req;
+	struct sink	 msgs;
+	char		*output;
+	size_t		 outsz;
+	ssize_t		 used;
+	int		 rc;
+
+	sink_init_buf(&msgs);
+	if ((used = request_parse(c->b, c->len, &req, &msgs)) > 0) {
+		output = NULL;
+		outsz = 0;
+		rc = msgs.len > 0 ? 5 :
+		    request_run(cache, &req, &output, &outsz, &msgs);
+		conn_respond(c, rc, output, outsz, &msgs);
+		free(output);
+		c->len -= used;
+		memmove(c->b, c->b + used, c->len);
+	} else if (used == -1 || c->eof) {
+		if (used == -1 && msgs.len > 0)
+			conn_respond(c, 5, NULL, 0, &msgs);
+		c->rc = 5;
+		c->eof = 1;
+		c->len = 0;
+	}
+	request_free(&req);
+	sink_free(&msgs);
+}
+
+/*
+ * Read what is available from c.
+ */
+static void
+conn_read(struct conn *c)
+{
+	ssize_t		 nr;
+
+	if (c->sz - c->len < BUFSIZ) {
+		c->sz = c->sz == 0 ? BUFSIZ * 2 : c->sz * 2;
+		c->b = xrealloc(c->b, c->sz);
+	}
+	if ((nr = read(c->ifd, c->b + c->len, c->sz - c->len)) > 0)
+		c->len += nr;
+	else if (nr == 0)
+		c->eof = 1;
+	else if (errno != EAGAIN && errno != EINTR) {
+		c->rc = 5;
+		c->eof = 1;
+		c->len = 0;
+	}
+}
+
+/*
+ * Send as much of the queued responses to c as possible.
+ */
+static void
+conn_write(struct conn *c)
+{
+	ssize_t		 nw;
+
+	if ((nw = write(c->ofd, c->out.b + c->off,
+	    c->out.len - c->off)) > 0) {
+		if ((c->off += nw) == c->out.len)
+			c->off = c->out.len = 0;
+	} else if (errno != EAGAIN && errno != EINTR) {
+		c->rc = 4;
+		c->eof = 1;
+		c->len = 0;
+		c->off = c->out.len = 0;
+	}
+}
+
+static void
+conn_init(struct conn *c, int ifd, int ofd)
+{
+	memset(c, 0, sizeof(*c));
+	c->ifd = ifd;
+	c->ofd = ofd;
+	sink_init_buf(&c->out);
+}
+
+/*
+ * Answer requests on all connections until the input of the last
+ * one ends, or forever if new connections are accepted on lfd.
+ * Requests are converted one after the other, but clients are only
+ * waited for when they have nothing to do, such that a client that
+ * is slow to send its request or to read its response does not hold
+ * up the others.  Return the exit status of the last connection.
+ */
+static int
+server_loop(int lfd, struct conn *conns, size_t nconn)
+{
+	struct d2m_cache	*cache;
+	struct pollfd		*pfd;
+	struct conn		*c;
+	size_t			 i, j, npfd;
+	int			 cfd, rc;
+
+	cache = d2m_cache_alloc();
+	pfd = NULL;
+	npfd = 0;
+	rc = 0;
+	for (;;) {
+		for (i = j = 0; i < nconn; i++) {
+			c = conns + i;
+			if (c->out.len == 0 && c->len > 0)
+				conn_serve(c, cache);
+			if (c->eof && c->len == 0 && c->out.len == 0) {
+				if (c->ofd != c->ifd)
+					close(c->ofd);
+				close(c->ifd);
+				free(c->b);
+				sink_free(&c->out);
+				rc = c->rc;
+			} else
+				conns[j++] = *c;
+		}
+		if ((nconn = j) == 0 && lfd == -1)
+			break;
+
+		if (npfd < nconn + 1) {
+			npfd = nconn + 1;
+			pfd = xreallocarray(pfd, npfd, sizeof(*pfd));
+		}
+		for (i = 0; i < nconn; i++) {
+			c = conns + i;
+			pfd[i].fd = c->out.len > 0 ? c->ofd : c->ifd;
+			pfd[i].events = c->out.len > 0 ? POLLOUT : POLLIN;
+		}
+		pfd[nconn].fd = lfd;
+		pfd[nconn].events = POLLIN;
+		if (poll(pfd, nconn + 1, -1) == -1) {
+			if (errno == EINTR)
+				continue;
+			perror("poll");
+			rc = 6;
+			break;
+		}
+		for (i = 0; i < nconn; i++) {
+			if (pfd[i].revents == 0)
+				continue;
+			if (conns[i].out.len > 0)
+				conn_write(conns + i);
+			else
+				conn_read(conns + i);
+		}
+		if ((pfd[nconn].revents & POLLIN) == 0)
+			continue;
+		if ((cfd = accept(lfd, NULL, NULL)) == -1) {
+			if (errno == EINTR || errno == ECONNABORTED ||
+			    errno == EAGAIN)
+				continue;
+			perror("accept");
+			rc = 6;
+			break;
+		}
+		if (fcntl(cfd, F_SETFL, O_NONBLOCK) == -1) {
+			perror("fcntl");
+			close(cfd);
+			continue;
+		}
+		conns = xreallocarray(conns, nconn + 1, sizeof(*conns));
+		conn_init(conns + nconn++, cfd, cfd);
+	}
+	for (i = 0; i < nconn; i++) {
+		close(conns[i].ifd);
+		free(conns[i].b);
+		sink_free(&conns[i].out);
+	}
+	free(conns);
+	free(pfd);
+	d2m_cache_free(cache);
+	return rc;
+}
+
+/*
+ * Serve requests on standard input if path is "-",
+ * or otherwise on a Unix domain socket bound to path.
+ * When listening on a socket, this only returns on failure.
+ */
+int
+server_run(const char *path)
+{
+	struct sockaddr_un	 sun;
+	struct stat		 st;
+	struct conn		*c;
+	int			 cfd, fd, rc;
+
+	/* Clients may close their connection before reading responses. */
+
+	signal(SIGPIPE, SIG_IGN);
+
+	if (strcmp(path, "-") == 0) {
+		c = xcalloc(1, sizeof(*c));
+		conn_init(c, STDIN_FILENO, STDOUT_FILENO);
+		return server_loop(-1, c, 1);
+	}
+
+	memset(&sun, 0, sizeof(sun));
+	sun.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(sun.sun_path)) {
+		fprintf(stderr, "%s: File name too long\n", path);
+		return 5;
+	}
+	memcpy(sun.sun_path, path, strlen(path));
+
+	if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
+		perror("socket");
+		return 6;
+	}
+
+	/*
+	 * Replace a stale socket, but never any other kind of file,
+	 * nor a socket that another server is still accepting on.
+	 */
+
+	if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+		if ((cfd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
+			perror("socket");
+			close(fd);
+			return 6;
+		}
+		if (connect(cfd, (struct sockaddr *)&sun, sizeof(sun)) == -1 &&
+		    errno == ECONNREFUSED)
+			unlink(path);
+		close(cfd);
+	}
+	if (bind(fd, (struct sockaddr *)&sun, sizeof(sun)) == -1 ||
+	    listen(fd, 16) == -1 || fcntl(fd, F_SETFL, O_NONBLOCK) == -1) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		close(fd);
+		return 6;
+	}
+	rc = server_loop(fd, NULL, 0);
+	close(fd);
+	return rc;
+}
@@ -0,0 +1,152 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "xmalloc.h"
+#include "sink.h"
+
+/*
+ * The implementation of the output sinks used by the formatters.
+ */
+
+#define	SINK_BUFSZ	8192
+
+void
+sink_init_fd(struct sink *s, int fd)
+{
+	memset(s, 0, sizeof(*s));
+	s->sz = SINK_BUFSZ;
+	s->b = xcalloc(1, s->sz);
+	s->fd = fd;
+}
+
+void
+sink_init_buf(struct sink *s)
+{
+	sink_init_fd(s, -1);
+}
+
+void
+sink_init_func(struct sink *s, sink_func *func, void *arg)
+{
+	sink_init_fd(s, -1);
+	s->func = func;
+	s->arg = arg;
+}
+
+void
+sink_free(struct sink *s)
+{
+	free(s->b);
+	s->b = NULL;
+	s->len = s->sz = 0;
+}
+
+/*
+ * Pass the buffered output on, unless the sink is a memory buffer.
+ * Return -1 if any write operation failed, or 0 otherwise.
+ */
+int
+sink_flush(struct sink *s)
+{
+	const char	*cp;
+	ssize_t		 wsz;
+
+	if (s->fd != -1) {
+		cp = s->b;
+		while (s->len > 0 && s->error == 0) {
+			if ((wsz = write(s->fd, cp, s->len)) == -1) {
+				if (errno != EINTR)
+					s->error = errno;
+				continue;
+			}
+			cp += wsz;
+			s->len -= wsz;
+		}
+		s->len = 0;
+	} else if (s->func != NULL) {
+		if (s->len > 0)
+			(*s->func)(s->arg, s->b, s->len);
+		s->len = 0;
+	}
+	return s->error == 0 ? 0 : -1;
+}
+
+/*
+ * Make room for at least sz more bytes in the buffer.
+ */
+static void
+sink_reserve(struct sink *s, size_t sz)
+{
+	if (s->sz - s->len >= sz)
+		return;
+	if (s->fd != -1 || s->func != NULL) {
+		sink_flush(s);
+		if (s->sz >= sz)
+			return;
+	}
+	while (s->sz - s->len < sz)
+		s->sz *= 2;
+	s->b = xrealloc(s->b, s->sz);
+}
+
+void
+sink_putc(struct sink *s, int c)
+{
+	if (s->len == s->sz)
+		sink_reserve(s, 1);
+	s->b[s->len++] = c;
+}
+
+void
+sink_write(struct sink *s, const char *buf, size_t sz)
+{
+	sink_reserve(s, sz);
+	memcpy(s->b + s->len, buf, sz);
+	s->len += sz;
+}
+
+void
+sink_puts(struct sink *s, const char *str)
+{
+	sink_write(s, str, strlen(str));
+}
+
+void
+sink_printf(struct sink *s, const char *fmt, ...)
+{
+	va_list		 ap;
+	int		 sz;
+
+	va_start(ap, fmt);
+	sz = vsnprintf(s->b + s->len, s->sz - s->len, fmt, ap);
+	va_end(ap);
+	if (sz < 0)
+		return;
+	if ((size_t)sz >= s->sz - s->len) {
+		sink_reserve(s, sz + 1);
+		va_start(ap, fmt);
+		vsnprintf(s->b + s->len, s->sz - s->len, fmt, ap);
+		va_end(ap);
+	}
+	s->len += sz;
+}
@@ -0,0 +1,48 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * The interface of the output sinks used by the formatters.
+ */
+
+typedef void	 sink_func(void *, const char *, size_t);
+
+/*
+ * Output is collected in a buffer.  When the buffer is full, it is
+ * written to the file descriptor or passed to the callback function.
+ * If there is neither, the buffer grows to hold the complete output.
+ */
+struct	sink {
+	char		*b;      /* Buffered output, not NUL-terminated. */
+	size_t		 len;    /* Number of bytes in b. */
+	size_t		 sz;     /* Allocated size of b. */
+	int		 fd;     /* Output file descriptor or -1. */
+	sink_func	*func;   /* Output callback function or NULL. */
+	void		*arg;    /* First argument for func. */
+	int		 error;  /* errno from the first failed write. */
+};
+
+void	 sink_init_fd(struct sink *, int);
+void	 sink_init_buf(struct sink *);
+void	 sink_init_func(struct sink *, sink_func *, void *);
+void	 sink_free(struct sink *);
+int	 sink_flush(struct sink *);
+
+void	 sink_putc(struct sink *, int);
+void	 sink_puts(struct sink *, const char *);
+void	 sink_write(struct sink *, const char *, size_t);
+void	 sink_printf(struct sink *, const char *, ...);
@@ -0,0 +1,435 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "xmalloc.h"
+#include "hash.h"
+#include "node.h"
+#include "sink.h"
+#include "snap.h"
+
+/*
+ * The implementation of the precompiled snapshots of entity files.
+ *
+ * A snapshot starts with a header, followed by the table of the
+ * files that were read, the table of the entities, the hash buckets,
+ * and the string pool.  All offsets are relative to the start of the
+ * snapshot.  The entities hashing to the same bucket are chained in
+ * the order of declaration, such that the first declaration of a
+ * name is found first, just like when searching the parse tree.
+ * Snapshots use the native byte order; a snapshot written on
+ * a different architecture is rejected by the header check.
+ * In the cache directory, the snapshot of an entity file is stored
+ * under the hex digest of its name, with the suffix ".ent".
+ */
+
+#define	SNAP_MAGIC	"d2ment1"
+#define	SNAP_ORDER	0x01020304
+#define	SNAP_ALIGN(x)	(((x) + 7) & ~(size_t)7)
+
+struct	snaphdr {
+	char		 magic[8];  /* SNAP_MAGIC */
+	uint32_t	 order;     /* SNAP_ORDER in native byte order. */
+	uint32_t	 size;      /* Size of the snapshot in bytes. */
+	uint32_t	 nfiles;    /* Number of files, at least one. */
+	uint32_t	 nents;     /* Number of entities. */
+	uint32_t	 nbuckets;  /* Number of buckets, a power of two. */
+	uint32_t	 files;     /* Offset of the file table. */
+	uint32_t	 ents;      /* Offset of the entity table. */
+	uint32_t	 buckets;   /* Offset of the bucket table. */
+	uint32_t	 strs;      /* Offset of the string pool. */
+	uint32_t	 pad;
+};
+
+struct	snapfent {
+	uint64_t	 dev;
+	uint64_t	 ino;
+	int64_t		 size;
+	int64_t		 sec;
+	int64_t		 nsec;
+	uint32_t	 path;      /* Offset of the file name. */
+	uint32_t	 pad;
+};
+
+struct	snapent {
+	uint32_t	 hash;      /* Hash value of the name. */
+	uint32_t	 next;      /* Next entity in the chain plus one. */
+	uint32_t	 name;      /* Offset of the entity name. */
+	uint32_t	 value;     /* Offset of the definition or path. */
+	uint32_t	 system;    /* The value is a system identifier. */
+};
+
+
+static uint32_t
+snap_hash(const char *s)
+{
+	uint32_t	 h;
+
+	for (h = 2166136261U; *s != '\0'; s++)
+		h = (h ^ (unsigned char)*s) * 16777619U;
+	return h;
+}
+
+#define	SNAP_HDR(s)	((const struct snaphdr *)(s)->b)
+#define	SNAP_FENT(s) \
+	((const struct snapfent *)((s)->b + SNAP_HDR(s)->files))
+#define	SNAP_ENT(s) \
+	((const struct snapent *)((s)->b + SNAP_HDR(s)->ents))
+#define	SNAP_BUCKET(s) \
+	((const uint32_t *)((s)->b + SNAP_HDR(s)->buckets))
+
+/*
+ * Compile the entity declarations starting at node n
+ * and continuing to the end of its parent into a snapshot.
+ * The first element of files is the entity file itself.
+ * Text nodes, for example from parameter entity references,
+ * are ignored, just like when searching the parse tree.
+ * Return NULL if any other node is not a plain entity declaration.
+ */
+struct snap *
+snap_build(struct pnode *n, const struct snapfile *files, size_t nfiles)
+{
+	struct snaphdr	*hdr;
+	struct snapfent	*fe;
+	struct snapent	*ents, *e;
+	struct snap	*s;
+	struct sink	 strs;
+	uint32_t	*buckets;
+	const char	*name, *value;
+	size_t		 i, nents, maxents, sz, h;
+	int		 system;
+
+	sink_init_buf(&strs);
+	ents = NULL;
+	nents = maxents = 0;
+	for (; n != NULL; n = PNODE_NEXT(n)) {
+		if (n->node == NODE_TEXT)
+			continue;
+		if (n->node != NODE_ENTITY ||
+		    PNODE_FIRST(n) != NULL) {
+			free(ents);
+			sink_free(&strs);
+			return NULL;
+		}
+		if ((name = pnode_getattr_raw(n, ATTRKEY_NAME, NULL)) == NULL)
+			continue;
+		if ((value = pnode_getattr_raw(n,
+		    ATTRKEY_SYSTEM, NULL)) != NULL)
+			system = 1;
+		else if ((value = pnode_getattr_raw(n,
+		    ATTRKEY_DEFINITION, NULL)) != NULL)
+			system = 0;
+		else
+			continue;
+		if (nents == maxents) {
+			maxents = maxents == 0 ? 64 : maxents * 2;
+			ents = xreallocarray(ents, maxents, sizeof(*ents));
+		}
+		e = ents + nents++;
+		e->hash = snap_hash(name);
+		e->system = system;
+		e->name = strs.len;
+		sink_write(&strs, name, strlen(name) + 1);
+		e->value = strs.len;
+		sink_write(&strs, value, strlen(value) + 1);
+	}
+
+	/* Lay out the snapshot. */
+
+	s = xcalloc(1, sizeof(*s));
+	hdr = xcalloc(1, sizeof(*hdr));
+	memcpy(hdr->magic, SNAP_MAGIC, sizeof(hdr->magic));
+	hdr->order = SNAP_ORDER;
+	hdr->nfiles = nfiles;
+	hdr->nents = nents;
+	for (hdr->nbuckets = 16; hdr->nbuckets < nents; hdr->nbuckets *= 2)
+		continue;
+	sz = SNAP_ALIGN(sizeof(*hdr));
+	hdr->files = sz;
+	sz += SNAP_ALIGN(nfiles * sizeof(*fe));
+	hdr->ents = sz;
+	sz += SNAP_ALIGN(nents * sizeof(*ents));
+	hdr->buckets = sz;
+	sz += SNAP_ALIGN(hdr->nbuckets * sizeof(*buckets));
+	hdr->strs = sz;
+	for (i = 0; i < nfiles; i++)
+		sink_write(&strs, files[i].path, strlen(files[i].path) + 1);
+	sz += strs.len;
+	if (sz > UINT32_MAX) {
+		free(hdr);
+		free(s);
+		free(ents);
+		sink_free(&strs);
+		return NULL;
+	}
+	hdr->size = sz;
+	s->sz = sz;
+	s->b = xcalloc(1, sz);
+	memcpy(s->b, hdr, sizeof(*hdr));
+	memcpy(s->b + hdr->strs, strs.b, strs.len);
+
+	/* Fill in the tables. */
+
+	fe = (struct snapfent *)(s->b + hdr->files);
+	h = hdr->strs + strs.len;
+	for (i = nfiles; i-- > 0; ) {
+		h -= strlen(files[i].path) + 1;
+		fe[i].path = h;
+		fe[i].dev = files[i].dev;
+		fe[i].ino = files[i].ino;
+		fe[i].size = files[i].size;
+		fe[i].sec = files[i].mtime.tv_sec;
+		fe[i].nsec = files[i].mtime.tv_nsec;
+	}
+	buckets = (uint32_t *)(s->b + hdr->buckets);
+	for (i = nents; i-- > 0; ) {
+		e = ents + i;
+		e->name += hdr->strs;
+		e->value += hdr->strs;
+		h = e->hash & (hdr->nbuckets - 1);
+		e->next = buckets[h];
+		buckets[h] = i + 1;
+	}
+	memcpy(s->b + hdr->ents, ents, nents * sizeof(*ents));
+	free(hdr);
+	free(ents);
+	sink_free(&strs);
+	return s;
+}
+
+/*
+ * Check that the snapshot in s is well-formed,
+ * such that no offset leads outside of it.
+ */
+static int
+snap_check(const struct snap *s)
+{
+	const struct snaphdr	*hdr;
+	const struct snapfent	*fe;
+	const struct snapent	*e;
+	const uint32_t		*buckets;
+	uint64_t		 i;
+
+	hdr = SNAP_HDR(s);
+	if (s->sz < sizeof(*hdr) ||
+	    memcmp(hdr->magic, SNAP_MAGIC, sizeof(hdr->magic)) != 0 ||
+	    hdr->order != SNAP_ORDER || hdr->size != s->sz ||
+	    hdr->nfiles == 0 || hdr->nbuckets == 0 ||
+	    (hdr->nbuckets & (hdr->nbuckets - 1)) != 0 ||
+	    hdr->files % 8 || hdr->ents % 8 || hdr->buckets % 8 ||
+	    hdr->files < sizeof(*hdr) ||
+	    hdr->files + (uint64_t)hdr->nfiles * sizeof(*fe) > hdr->ents ||
+	    hdr->ents + (uint64_t)hdr->nents * sizeof(*e) > hdr->buckets ||
+	    hdr->buckets + (uint64_t)hdr->nbuckets * sizeof(*buckets) >
+	    hdr->strs || hdr->strs >= s->sz || s->b[s->sz - 1] != '\0')
+		return -1;
+	fe = SNAP_FENT(s);
+	for (i = 0; i < hdr->nfiles; i++)
+		if (fe[i].path < hdr->strs || fe[i].path >= s->sz)
+			return -1;
+	e = SNAP_ENT(s);
+	for (i = 0; i < hdr->nents; i++)
+		if (e[i].name < hdr->strs || e[i].name >= s->sz ||
+		    e[i].value < hdr->strs || e[i].value >= s->sz ||
+		    (e[i].next != 0 && (e[i].next <= i + 1 ||
+		     e[i].next > hdr->nents)))
+			return -1;
+	buckets = SNAP_BUCKET(s);
+	for (i = 0; i < hdr->nbuckets; i++)
+		if (buckets[i] > hdr->nents)
+			return -1;
+	return 0;
+}
+
+/*
+ * The name of the snapshot of the entity file path in directory dir.
+ */
+static char *
+snap_fname(const char *dir, const char *path)
+{
+	struct hash	 h;
+	char		*fname;
+	char		 hex[HASH_HEXSZ];
+
+	hash_init(&h);
+	hash_update(&h, SNAP_MAGIC, sizeof(SNAP_MAGIC));
+	hash_update(&h, path, strlen(path));
+	hash_final(&h, hex);
+	xasprintf(&fname, "%s/%s.ent", dir, hex);
+	return fname;
+}
+
+/*
+ * Map the snapshot of the entity file path from directory dir.
+ * Return NULL if there is none or if it is unusable.
+ * The caller still needs to check that it is up to date.
+ */
+struct snap *
+snap_load(const char *dir, const char *path)
+{
+	struct stat	 st;
+	struct snap	*s;
+	struct snapfile	 sf;
+	char		*fname;
+	void		*b;
+	int		 fd;
+
+	fname = snap_fname(dir, path);
+	fd = open(fname, O_RDONLY, 0);
+	free(fname);
+	if (fd == -1)
+		return NULL;
+	if (fstat(fd, &st) == -1 ||
+	    st.st_size < (off_t)sizeof(struct snaphdr) ||
+	    st.st_size > UINT32_MAX ||
+	    (b = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+	     fd, 0)) == MAP_FAILED) {
+		close(fd);
+		return NULL;
+	}
+	close(fd);
+	s = xcalloc(1, sizeof(*s));
+	s->b = b;
+	s->sz = st.st_size;
+	s->mapped = 1;
+	if (snap_check(s) == -1 || snap_file(s, 0, &sf) == -1 ||
+	    strcmp(sf.path, path) != 0) {
+		snap_free(s);
+		return NULL;
+	}
+	return s;
+}
+
+/*
+ * Store the snapshot s in directory dir, ignoring failure.
+ */
+void
+snap_save(const struct snap *s, const char *dir)
+{
+	struct snapfile	 sf;
+	struct sink	 out;
+	char		*tmp, *fname;
+	int		 fd, rc;
+
+	xasprintf(&tmp, "%s/tmp.XXXXXXXXXX", dir);
+	if ((fd = mkstemp(tmp)) == -1) {
+		free(tmp);
+		return;
+	}
+	sink_init_fd(&out, fd);
+	sink_write(&out, s->b, s->sz);
+	rc = sink_flush(&out);
+	sink_free(&out);
+	if (close(fd) == -1)
+		rc = -1;
+	if (rc == 0 && snap_file(s, 0, &sf) == 0) {
+		fname = snap_fname(dir, sf.path);
+		if (rename(tmp, fname) == -1)
+			rc = -1;
+		free(fname);
+	} else
+		rc = -1;
+	if (rc == -1)
+		unlink(tmp);
+	free(tmp);
+}
+
+/*
+ * Retrieve the file number i that was read while parsing.
+ * Return -1 if there is no such file.
+ */
+int
+snap_file(const struct snap *s, size_t i, struct snapfile *sf)
+{
+	const struct snapfent	*fe;
+
+	if (i >= SNAP_HDR(s)->nfiles)
+		return -1;
+	fe = SNAP_FENT(s) + i;
+	sf->path = s->b + fe->path;
+	sf->dev = fe->dev;
+	sf->ino = fe->ino;
+	sf->size = fe->size;
+	sf->mtime.tv_sec = fe->sec;
+	sf->mtime.tv_nsec = fe->nsec;
+	return 0;
+}
+
+/*
+ * Check that none of the files read while parsing changed since.
+ */
+int
+snap_valid(const struct snap *s)
+{
+	struct stat	 st;
+	struct snapfile	 sf;
+	size_t		 i;
+
+	for (i = 0; snap_file(s, i, &sf) == 0; i++)
+		if (stat(sf.path, &st) == -1 ||
+		    st.st_dev != sf.dev || st.st_ino != sf.ino ||
+		    st.st_size != sf.size ||
+		    st.st_mtim.tv_sec != sf.mtime.tv_sec ||
+		    st.st_mtim.tv_nsec != sf.mtime.tv_nsec)
+			return 0;
+	return 1;
+}
+
+/*
+ * Look up the first declaration of the entity name.
+ * Return its definition or NULL if it is not declared,
+ * and set *system if the value is a system identifier.
+ */
+const char *
+snap_lookup(const struct snap *s, const char *name, int *system)
+{
+	const struct snapent	*e;
+	uint32_t		 h, i;
+
+	h = snap_hash(name);
+	i = SNAP_BUCKET(s)[h & (SNAP_HDR(s)->nbuckets - 1)];
+	while (i != 0) {
+		e = SNAP_ENT(s) + (i - 1);
+		if (e->hash == h && strcmp(s->b + e->name, name) == 0) {
+			*system = e->system;
+			return s->b + e->value;
+		}
+		i = e->next;
+	}
+	return NULL;
+}
+
+void
+snap_free(struct snap *s)
+{
+	if (s == NULL)
+		return;
+	if (s->mapped)
+		munmap(s->b, s->sz);
+	else
+		free(s->b);
+	free(s);
+}
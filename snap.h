@@ -0,0 +1,55 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHORS DISCLAIM ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * The interface of the precompiled snapshots of files
+ * containing entity declarations.
+ */
+
+/*
+ * A file read while parsing an entity file,
+ * and its identity at the time it was read.
+ */
+struct	snapfile {
+	const char	*path;   /* Relative to the cwd. */
+	dev_t		 dev;
+	ino_t		 ino;
+	off_t		 size;
+	struct timespec	 mtime;
+};
+
+/*
+ * The entity declarations of one file and of the files it includes,
+ * in a binary format with a hash index, either mapped from a file
+ * in the cache directory or built in memory.
+ */
+struct	snap {
+	struct snap	*next;   /* Next snapshot in the same cache. */
+	char		*b;      /* Snapshot data. */
+	size_t		 sz;     /* Size of b in bytes. */
+	int		 mapped; /* b is mapped with mmap(2). */
+	int		 stale;  /* One of the files changed. */
+	int		 nuse;   /* Number of parsers using it. */
+};
+
+struct snap	*snap_build(struct pnode *, const struct snapfile *, size_t);
+struct snap	*snap_load(const char *, const char *);
+void		 snap_save(const struct snap *, const char *);
+int		 snap_file(const struct snap *, size_t, struct snapfile *);
+int		 snap_valid(const struct snap *);
+const char	*snap_lookup(const struct snap *, const char *, int *);
+void		 snap_free(struct snap *);
@@ -14,38 +14,42 @@
  * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
-#include <stdio.h>
+#include <sys/types.h>
+
+#include <stddef.h>
 
 #include "node.h"
+#include "sink.h"
 #include "format.h"
 
 /*
  * The implementation of the parse tree dumper.
  */
 
-void
-print_node(struct pnode *n, int indent)
+static void
+print_node(struct sink *out, struct pnode *n, int indent)
 {
 	struct pnode	*nc;
 	struct pattr	*a;
 
-	printf("%*s%c%s", indent, "",
+	sink_printf(out, "%*s%c%s", indent, "",
 	    (n->flags & NFLAG_LINE) ? '*' :
 	    (n->flags & NFLAG_SPC) ? ' ' : '-',
 	    pnode_name(n->node));
-	if (n->b != NULL) {
-		putchar(' ');
-		fputs(n->b, stdout);
+	if (PNODE_ISTEXT(n) && n->u.b != NULL) {
+		sink_putc(out, ' ');
+		sink_puts(out, n->u.b);
 	}
-	TAILQ_FOREACH(a, &n->attrq, child)
-		printf(" %s='%s'", attrkey_name(a->key), attr_getval(a));
-	putchar('\n');
-	TAILQ_FOREACH(nc, &n->childq, child)
-		print_node(nc, indent + 2);
+	PATTR_FOREACH(a, n)
+		sink_printf(out, " %s='%s'",
+		    attrkey_name(a->key), attr_getval(a));
+	sink_putc(out, '\n');
+	PNODE_FOREACH(nc, n)
+		print_node(out, nc, indent + 2);
 }
 
 void
-ptree_print_tree(struct ptree *tree)
+ptree_print_tree(struct ptree *tree, struct sink *out)
 {
-	print_node(tree->root, 0);
+	print_node(out, tree->root, 0);
 }
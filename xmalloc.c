@@ -16,7 +16,9 @@
  */
 #include <sys/types.h>
 
+#include <errno.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -28,6 +30,32 @@
  * The implementation of the exiting allocator functions.
  */
 
+/*
+ * A block of memory handed out by an arena, following the header.
+ */
+struct	achunk {
+	struct achunk	*next;
+	size_t		 sz;      /* Usable size after the header. */
+};
+
+/*
+ * Small requests are carved from the first chunk in the list.
+ * Chunk sizes double up to ARENA_MAX, such that small arenas
+ * stay small and large ones need few chunks.  Requests too large
+ * for that get chunks of their own in a separate list.
+ */
+struct	arena {
+	struct achunk	*chunks;  /* Newest and largest first. */
+	struct achunk	*big;     /* Chunks for one large request each. */
+	char		*cur;     /* Free space in the first chunk. */
+	char		*end;     /* End of the first chunk. */
+	size_t		 next;    /* Size of the next chunk. */
+};
+
+#define	ARENA_MIN	 1024		/* Size of the first chunk. */
+#define	ARENA_MAX	 (1024 * 1024)	/* Maximum size of chunks. */
+#define	ARENA_ALIGN	 16		/* Alignment of arena_calloc(). */
+
 void *
 xcalloc(size_t nmemb, size_t size)
 {
@@ -100,3 +128,128 @@ xasprintf(char **dest, const char *fmt, ...)
 	}
 	return ret;
 }
+
+struct arena *
+arena_alloc(void)
+{
+	struct arena	*a;
+
+	a = xcalloc(1, sizeof(*a));
+	a->next = ARENA_MIN;
+	return a;
+}
+
+static struct achunk *
+arena_chunk(size_t sz)
+{
+	struct achunk	*c;
+
+	if (sz > SIZE_MAX - sizeof(*c)) {
+		errno = ENOMEM;
+		perror(NULL);
+		exit(6);
+	}
+	c = xcalloc(1, sizeof(*c) + sz);
+	c->sz = sz;
+	return c;
+}
+
+/*
+ * Return sz bytes of uninitialized memory with the given alignment,
+ * which is a power of two.
+ */
+static void *
+arena_get(struct arena *a, size_t sz, size_t align)
+{
+	struct achunk	*c;
+	uintptr_t	 cur;
+
+	cur = ((uintptr_t)a->cur + align - 1) & ~(uintptr_t)(align - 1);
+	if (a->cur != NULL && cur <= (uintptr_t)a->end &&
+	    sz <= (uintptr_t)a->end - cur) {
+		a->cur = (char *)cur + sz;
+		return (char *)cur;
+	}
+	if (sz > a->next / 4) {
+		c = arena_chunk(sz + align);
+		c->next = a->big;
+		a->big = c;
+		cur = (uintptr_t)(c + 1);
+		return (char *)((cur + align - 1) & ~(uintptr_t)(align - 1));
+	}
+	c = arena_chunk(a->next);
+	c->next = a->chunks;
+	a->chunks = c;
+	if (a->next < ARENA_MAX)
+		a->next *= 2;
+	a->cur = (char *)(c + 1);
+	a->end = a->cur + c->sz;
+	return arena_get(a, sz, align);
+}
+
+void *
+arena_calloc(struct arena *a, size_t nmemb, size_t size)
+{
+	void	*p;
+
+	if (size != 0 && nmemb > SIZE_MAX / size) {
+		errno = ENOMEM;
+		perror(NULL);
+		exit(6);
+	}
+	p = arena_get(a, nmemb * size, ARENA_ALIGN);
+	memset(p, 0, nmemb * size);
+	return p;
+}
+
+char *
+arena_strdup(struct arena *a, const char *in)
+{
+	return arena_strndup(a, in, strlen(in));
+}
+
+char *
+arena_strndup(struct arena *a, const char *in, size_t maxlen)
+{
+	char	*out;
+	size_t	 sz;
+
+	sz = strnlen(in, maxlen);
+	out = arena_get(a, sz + 1, 1);
+	memcpy(out, in, sz);
+	out[sz] = '\0';
+	return out;
+}
+
+/*
+ * Release all memory handed out by the arena,
+ * but keep the largest chunk for reuse.
+ */
+void
+arena_reset(struct arena *a)
+{
+	struct achunk	*c, *nc;
+
+	while ((c = a->big) != NULL) {
+		a->big = c->next;
+		free(c);
+	}
+	if ((c = a->chunks) == NULL)
+		return;
+	while ((nc = c->next) != NULL) {
+		c->next = nc->next;
+		free(nc);
+	}
+	a->cur = (char *)(c + 1);
+	a->end = a->cur + c->sz;
+}
+
+void
+arena_free(struct arena *a)
+{
+	if (a == NULL)
+		return;
+	arena_reset(a);
+	free(a->chunks);
+	free(a);
+}
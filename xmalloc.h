@@ -27,3 +27,17 @@ char	*xstrdup(const char *);
 char	*xstrndup(const char *, size_t);
 
 int	 xasprintf(char **, const char *, ...);
+
+/*
+ * Arenas hand out memory that is released all at once,
+ * by arena_reset() for reuse or by arena_free().
+ */
+
+struct arena;	 /* Opaque object; used only in xmalloc.c. */
+
+struct arena	*arena_alloc(void);
+void		*arena_calloc(struct arena *, size_t, size_t);
+char		*arena_strdup(struct arena *, const char *);
+char		*arena_strndup(struct arena *, const char *, size_t);
+void		 arena_reset(struct arena *);
+void		 arena_free(struct arena *);